@@ -1,7 +1,33 @@
 #include "Game.h"
+#include "startuptables.h"
+#include "Physics.h"
 
 
-TSpritePool gSpritePool( true );
+TSpritePool gSpritePool( true, true );
+TGameDuino::TBusStats gLastFrameBusStats;
+TCharacterCache gCharacterCache;
+TSpritePaletteCache gSpritePalettes;
+TPhysicsBodies gPhysics;
+
+//	number of non-input players to spawn (the input player is added on top, so max 255)
+#if !defined(MONKEYFIGHT_PLAYER_COUNT)
+#define MONKEYFIGHT_PLAYER_COUNT	10
+#endif
+
+#define COLLISION_TESTS_PER_PLAYER	6		//	a packed crowd has ~3.5 pairs per player
+#define MAX_COLLISION_TESTS		((MONKEYFIGHT_PLAYER_COUNT+1) * COLLISION_TESTS_PER_PLAYER)
+#define PLAYER_FRICTION			0.3f
+#define GLOVE_FRICTION			0.6f
+#define BROADPHASE_MARGIN		2		//	slack for forces applied during the collision pass
+
+//	visible playfield in pixels
+#define PLAYFIELD_WIDTH			400
+#define PLAYFIELD_HEIGHT		300
+
+//	time we get per frame (72hz) and how much of it to leave for the vblank flush
+#define FRAME_TIME_US				13888
+#define FRAME_FLUSH_RESERVE_US		2000
+#define SPRITE_IMAGE_STREAM_BYTES	512		//	per frame, keeps streaming from filling the vram queue
 
 namespace TButton
 {
@@ -20,29 +46,6 @@ namespace TButton
 	u8		GetBit(TButton::Type Button)	{	return 1<<static_cast<u8>(Button);	}
 };
 
-class TCollisionShape
-{
-public:
-	TCollisionShape() :
-		mRadius		( -1.f ),
-		mStatic		( false )
-	{
-	}
-	TCollisionShape(const TPointf& Position,float Radius,bool Static) :
-		mPosition	( Position ),
-		mRadius		( Radius ),
-		mStatic		( Static )
-	{
-	}
-
-	bool			IsValid() const		{	return mRadius > 0.f;	}
-
-public:
-	TPointf		mPosition;	//	offset from parent's pos
-	float		mRadius;
-	bool		mStatic;	//	if static, object will not move
-};
-
 class TInputSource
 {
 public:
@@ -116,20 +119,20 @@ public:
 	bool	IsPressed(TButton::Type Button) const		{	return (mButtonPressed & TButton::GetBit(Button))!=0;	}
 	bool	IsReleased(TButton::Type Button) const		{	return (mButtonReleased & TButton::GetBit(Button))!=0;	}
 
-	TPointf	GetDirectionVector() const
+	TPhysicsPoint	GetDirectionVector() const
 	{
 		//T s = static_cast<T>(sqrt(v.x*v.x + v.y*v.y));
 		float Hyp_1x1 = 1.4142135623730950488016887242097f;
-		float OpAd_Hyp_1x1 = 1.f / Hyp_1x1;
+		TPhysicsScalar OpAd_Hyp_1x1 = 1.f / Hyp_1x1;
 
-		TPointf Dir(0,0);
-		Dir.y += IsDown( TButton::Down ) ? 1.f : 0.f;
-		Dir.y -= IsDown( TButton::Up ) ? 1.f : 0.f;
-		Dir.x += IsDown( TButton::Right ) ? 1.f : 0.f;
-		Dir.x -= IsDown( TButton::Left ) ? 1.f : 0.f;
+		TPhysicsPoint Dir(0,0);
+		Dir.y += IsDown( TButton::Down ) ? 1 : 0;
+		Dir.y -= IsDown( TButton::Up ) ? 1 : 0;
+		Dir.x += IsDown( TButton::Right ) ? 1 : 0;
+		Dir.x -= IsDown( TButton::Left ) ? 1 : 0;
 		
 		//	normalise so up-left doesn't move 2 spaces
-		if ( Dir.x != 0.f && Dir.y != 0.f )
+		if ( Dir.x != 0 && Dir.y != 0 )
 			Dir *= OpAd_Hyp_1x1;
 		
 		return Dir;
@@ -149,29 +152,6 @@ private:
 	u8				mButtonReleased;
 };
 
-class TPhysicsObject
-{
-public:
-	TCollisionShape	GetWorldCollisionShape() const			
-	{	
-		return TCollisionShape( mCollision.mPosition + mVelocity + mForce, mCollision.mRadius, mCollision.mStatic );	
-	}
-
-	void	PostUpdate(float Friction)
-	{
-		//	move with velocity
-		mCollision.mPosition += mVelocity;
-		
-		//	dampen velocity
-		mVelocity *= 1.f - Friction;
-	}
-
-public:
-	TCollisionShape	mCollision;
-	TPointf			mForce;
-	TPointf			mVelocity;
-};
-
 class TPlayer
 {
 public:
@@ -183,27 +163,26 @@ public:
 		mGloveAngleDeg			( 0.f ),
 		mGloveDistance			( 20.f )
 	{
-		mPlayerPhysics.mCollision.mPosition.x = Sprite.mPosition.x;
-		mPlayerPhysics.mCollision.mPosition.y = Sprite.mPosition.y;
-		mPlayerPhysics.mCollision.mRadius = Collision.mRadius;
+		mPlayerBody = gPhysics.AllocBody( TPhysicsPoint( Sprite.mPosition.x, Sprite.mPosition.y ), Collision.mRadius, false, PLAYER_FRICTION );
+		mGloveBody = gPhysics.AllocBody( TPhysicsPoint( 0, 0 ), TCollisionShape().mRadius, false, GLOVE_FRICTION );
 		mPlayerSpriteOffset.x = -Collision.mPosition.x;
 		mPlayerSpriteOffset.y = -Collision.mPosition.y;
 	}
 
 	void			SetInputSource(TInputSource* pInputSource)	{	mInput.SetInputSource( pInputSource );	}
-	TCollisionShape	GetPlayerWorldCollisionShape() const		{	return mPlayerPhysics.GetWorldCollisionShape();	}
-	TCollisionShape	GetGloveWorldCollisionShape() const			{	return mGlovePhysics.GetWorldCollisionShape();	}
-	const TPointf&	GetPlayerPosition() const					{	return mPlayerPhysics.mCollision.mPosition;	}
-	const TPointf&	GetGlovePosition() const					{	return mGlovePhysics.mCollision.mPosition;	}
+	TCollisionShape	GetPlayerWorldCollisionShape() const		{	return gPhysics.GetWorldCollisionShape( mPlayerBody );	}
+	TCollisionShape	GetGloveWorldCollisionShape() const			{	return gPhysics.GetWorldCollisionShape( mGloveBody );	}
+	TPhysicsPoint	GetPlayerPosition() const					{	return gPhysics.GetPosition( mPlayerBody );	}
+	TPhysicsPoint	GetGlovePosition() const					{	return gPhysics.GetPosition( mGloveBody );	}
 
 
 public:
 	TInput			mInput;
 	
-	TPhysicsObject	mPlayerPhysics;
-	TPhysicsObject	mGlovePhysics;
+	u16				mPlayerBody;			//	index into gPhysics
+	u16				mGloveBody;
 
-	TPointf			mPlayerSpriteOffset;	//	main sprite offset from collision shape
+	TPhysicsPoint	mPlayerSpriteOffset;	//	main sprite offset from collision shape
 	TSpriteInfo		mPlayerSpriteInfo;
 	TSpriteRef		mPlayerSpriteRef;
 	
@@ -216,22 +195,20 @@ public:
 BufferArray<TPlayer,256> gPlayers;
 
 
-u8 Lerp(const u8& From,const u8& To,float Time)
-{
-	float Fromf = static_cast<float>( From );
-	float Tof = static_cast<float>( To );
-	float Valuef = ((Tof - Fromf) * Time) + Fromf;
-	return static_cast<u8>( Valuef );
-}
+TSpriteImageSource_Progmem gSphereImages( sphere_images, SPHERE_IMAGE_COUNT );
+TSpriteImageCache gSpriteImages( gSphereImages );
 
 
 void TGame::Init()
 {
-	float CharacterRadius = 8.f;
+	TPhysicsScalar CharacterRadius = 8.f;
 
 
 	GD.ascii();
-	GD.putstr(0, 0, "Hi");
+	TGameDuino::PutString( 0, 0, "Hi" );
+
+	//	the debug font owns the printable characters
+	gCharacterCache.Reserve( ' ', 0x80-' ' );
 	
 	//	generate palette
 	BufferArray<TColour16,4> Palette;
@@ -239,7 +216,6 @@ void TGame::Init()
 	Palette.PushBack( TColour16( 0,	22, 0,	1 ) );
 	Palette.PushBack( TColour16( 0,	0, 22, 1 ) );
 	Palette.PushBack( TColour16( 22, 22, 0, 1 ) );
-	TGameDuino::SetMapPalette( Palette );
 
 	//	generate characters
 	BufferArray<TCharacter,1> Chars;
@@ -270,8 +246,6 @@ void TGame::Init()
 
 	}
 	
-	TGameDuino::SetMapCharacters( Chars );
-	
 	
 	//	generate background character map
 	//	only 400x300 pixels are visible or 50x37
@@ -281,86 +255,52 @@ void TGame::Init()
 	{
 		for ( int x=0;	x<50;	x++ )
 		{
-			u8 Char = i % Chars.GetSize();			
+			int Slot = gCharacterCache.AcquireCharacter( Chars[ i % Chars.GetSize() ], Palette );
+			assert( Slot >= 0, "Out of map characters" );
 			i++;
-			Map.Set( x, y, Char );
+			Map.Set( x, y, Slot );
 		}
 	}
 	TGameDuino::SetMapScroll( Type2<u16>(0,0) );
 	TGameDuino::SetMap( Map );
 	//GD.ascii();
-	GD.putstr(0, 0, "Hi");
+	TGameDuino::PutString( 0, 0, "Hi" );
 	
 
-	//	setup rainbow sprite palette
-	BufferArray<TColour16,256> RedPal;
-	BufferArray<TColour16,256> GreenPal;
-	BufferArray<TColour16,256> BluePal;
-	BufferArray<TColour16,256> GreyPal;
-	for ( int i=0;	i<256;	i++ )
+	//	rainbow sprite palettes
+	BufferArray<u8,RAINBOW_PALETTE_COUNT> RainbowPalettes;
+	for ( int i=0;	i<RAINBOW_PALETTE_COUNT;	i++ )
+		RainbowPalettes.PushBack( gSpritePalettes.AcquirePaletteProgmem( &rainbow_palettes[ i * GD_PAL256_SIZE ], 256 ) );
+
+	//	sprite images for the players, loaded now so they're ready for the first frame
+	BufferArray<u8,SPHERE_IMAGE_COUNT> SphereImages;
+	for ( int i=0;	i<gSphereImages.GetImageCount();	i++ )
 	{
-		bool Solid = i>0;
-		u8 Component = 255-i;
-		RedPal.PushBack( TColour16( Component, 0, 0, Solid ) );
-		GreenPal.PushBack( TColour16( 0, Component, 0, Solid ) );
-		BluePal.PushBack( TColour16( 0, 0, Component, Solid ) );
-		GreyPal.PushBack( TColour16( Component, Component, Component, Solid ) );
+		int Slot = gSpriteImages.AcquireImage( i, true );
+		assert( Slot >= 0, "Out of sprite images" );
+		SphereImages.PushBack( Slot );
 	}
-	
-	TGameDuino::SetSpritePalette( RedPal, TGameDuino::TSpritePal::Pal256, 0 );
-	TGameDuino::SetSpritePalette( GreenPal, TGameDuino::TSpritePal::Pal256, 1 );
-	TGameDuino::SetSpritePalette( BluePal, TGameDuino::TSpritePal::Pal256, 2 );
-	TGameDuino::SetSpritePalette( GreyPal, TGameDuino::TSpritePal::Pal256, 3 );
-
-	//	make up a sprite graphic per palette (these are exactly the same)
-	TSpriteCharacter SphereCharactera;
-	TSpriteCharacter SphereCharacterb;
-	TSpriteCharacter SphereCharacterc;
-	TSpriteCharacter SphereCharacterd;
-	for ( int x=0;	x<GD_SPRITE_WIDTH;	x++ )
-	{
-		for ( int y=0;	y<GD_SPRITE_HEIGHT;	y++ )
-		{
-			bool Transparent = false;
-			u8 FullColour = x+y*GD_SPRITE_WIDTH;
-			TPointf DistToCenter( x-8, y-8 );
-			Transparent = ( DistToCenter.GetLengthSq() >= CharacterRadius*CharacterRadius );
-			
-			u8 Coloura = Lerp(0,64, static_cast<float>(x+y*GD_SPRITE_WIDTH)/256.f );
-			u8 Colourb = Lerp(64,128, static_cast<float>(x+y*GD_SPRITE_WIDTH)/256.f );
-			u8 Colourc = Lerp(128,192, static_cast<float>(x+y*GD_SPRITE_WIDTH)/256.f );
-			u8 Colourd = Lerp(192,256, static_cast<float>(x+y*GD_SPRITE_WIDTH)/256.f );
-
-			SphereCharactera.Set( x, y, Transparent ? 0 : Coloura );
-			SphereCharacterb.Set( x, y, Transparent ? 0 : Colourb );
-			SphereCharacterc.Set( x, y, Transparent ? 0 : Colourc );
-			SphereCharacterd.Set( x, y, Transparent ? 0 : Colourd );
-		}
-	}
-	TGameDuino::SetSpriteCharacter( SphereCharactera, 0 );
-	TGameDuino::SetSpriteCharacter( SphereCharacterb, 1 );
-	TGameDuino::SetSpriteCharacter( SphereCharacterc, 2 );
-	TGameDuino::SetSpriteCharacter( SphereCharacterd, 3 );
 
 
 	//	sphere, pal 123
 	BufferArray<Type2<u8>,20> PlayerSpriteCharPal;
-	for ( int pal=1;	pal<=3;	pal++ )
+	for ( int p=1;	p<=3;	p++ )
 	{
-		PlayerSpriteCharPal.PushBack( Type2<u8>( 0, pal ) );
-		PlayerSpriteCharPal.PushBack( Type2<u8>( 1, pal ) );
-		PlayerSpriteCharPal.PushBack( Type2<u8>( 2, pal ) );
-		PlayerSpriteCharPal.PushBack( Type2<u8>( 3, pal ) );
+		u8 pal = gSpritePalettes.GetSpritePaletteSelect( RainbowPalettes[p] );
+		PlayerSpriteCharPal.PushBack( Type2<u8>( SphereImages[0], pal ) );
+		PlayerSpriteCharPal.PushBack( Type2<u8>( SphereImages[1], pal ) );
+		PlayerSpriteCharPal.PushBack( Type2<u8>( SphereImages[2], pal ) );
+		PlayerSpriteCharPal.PushBack( Type2<u8>( SphereImages[3], pal ) );
 	}
 
 	//	0, red pal
 	Type2<u8> GloveSpriteCharPal;
-	GloveSpriteCharPal = Type2<u8>( 0, 0 );
+	GloveSpriteCharPal = Type2<u8>( SphereImages[0], gSpritePalettes.GetSpritePaletteSelect( RainbowPalettes[0] ) );
 
 	//	make up players
-	int PlayerCount = 10;
+	int PlayerCount = MONKEYFIGHT_PLAYER_COUNT;
 	BufferArray<float,4> Speeds;
-	TCollisionShape PlayerCollision( TPointf(8,8), CharacterRadius, false );
+	TCollisionShape PlayerCollision( TPhysicsPoint(8,8), CharacterRadius, false );
 	Speeds.PushBack( 0.1f );
 	Speeds.PushBack( 0.2f );
 	Speeds.PushBack( 0.5f );
@@ -370,11 +310,14 @@ void TGame::Init()
 		auto& CharPal = PlayerSpriteCharPal[ p%PlayerSpriteCharPal.GetSize() ];
 		u8 Character = CharPal.x;
 		u8 Palette = CharPal.y;
-		TPoint Pos( 100 + 10*p, 60 + 10*p );
+		//	diagonal lines of players, a new line starts every 22 so big crowds stay on screen
+		int Line = p / 22;
+		int LinePos = p % 22;
+		TPoint Pos( (100 + 10*LinePos + 12*Line) % 384, 60 + 10*LinePos );
 		TPlayer& Player = gPlayers.PushBack( TPlayer( TSpriteInfo( Pos, Character, Palette ), PlayerCollision ) );
 
 		if ( p==0 || p==3 || p==8 )
-			Player.mPlayerPhysics.mCollision.mStatic = true;
+			gPhysics.SetStatic( Player.mPlayerBody, true );
 
 		Player.mPlayerSpriteRef = gSpritePool.AllocSprite( Player.mPlayerSpriteInfo );
 	}
@@ -392,273 +335,365 @@ void TGame::Init()
 }
 
 
-struct TIntersection
-{
-	TPointf		mMidPoint;
-	float		mDistance;
-	TPointf		mIntersection;
-	TPointf		mOtherIntersection;
-	float		mForceWeight;		//	intersection weight 0..1 0.5/0.5	if both objects have the same force impant
-};
-
-namespace TLMaths
-{
-	const float	g_NearZero = 0.0001f;
-};
-
-bool GetIntersection(TCollisionShape& a,TCollisionShape& b,TIntersection& NodeAIntersection,TIntersection& NodeBIntersection,TPhysicsObject& ObjectA,TPhysicsObject& ObjectB)
+void Update_Input()
 {
-	//	get the vector between the spheres
-	TPointf Diff( b.mPosition - a.mPosition );
-	//float2 Diff = NodeAIntersection.mDistance;
-
-	//	too embedded to do anything with it 
-	float DiffLengthSq = Diff.GetLengthSq();
-	if ( DiffLengthSq < TLMaths::g_NearZero )     
-		return false;   
-
-	float TotalRadSq = a.mRadius + b.mRadius;
-	TotalRadSq *= TotalRadSq;
-
-	//	too far away to intersect
-	if ( DiffLengthSq > TotalRadSq )
-		return false;
-
-	//	save distance
-	//	gr: should this be a vector?
-	NodeAIntersection.mDistance = sqrtf(DiffLengthSq);
+	TPhysicsScalar InputForce = 0.6f;
 
-	//	calc impact weighting
-	if ( a.mStatic != b.mStatic )
-	{
-		NodeAIntersection.mForceWeight = a.mStatic ? 1.f : 0.f;
-	}
-	else
+	//	update input
+	for ( int p=0;	p<gPlayers.GetSize();	p++ )
 	{
-		//	work out relative weights of object
-		float ObjectAWeight = 0.5f;
+		auto& Player = gPlayers[p];
+		Player.mInput.Update();
 
-		//	get force relativity (both weighting and then dotproduct relevance)
-		TPointf ObjectAForce = ObjectA.mForce + ObjectA.mVelocity;
-		TPointf ObjectBForce = ObjectB.mForce + ObjectB.mVelocity;
+		//	get direction vector
+		TPhysicsPoint InputDirection = Player.mInput.GetDirectionVector();
+		InputDirection *= InputForce;
 		
-		//	force weight
-		NodeAIntersection.mForceWeight = ObjectAWeight;
+		//	apply input
+		gPhysics.AddForce( Player.mPlayerBody, InputDirection );
 	}
+}
 
+void Update_PhysicsPreUpdate()
+{
+	//	try and position glove here relative to our direction
+	//	spring distance of glove to desired length
+	//	this is for movement, when rotating, and after our glove has been pushed out of place
 
-	//	intersected, work out the intersection points
-	NodeAIntersection.mIntersection = Diff;
-	NodeAIntersection.mIntersection.Normalise( a.mRadius );
-	NodeAIntersection.mIntersection += a.mPosition;
-	
-	NodeAIntersection.mOtherIntersection = Diff;
-	NodeAIntersection.mOtherIntersection.Normalise( b.mRadius );
-	NodeAIntersection.mOtherIntersection += b.mPosition;	
-	
-	NodeAIntersection.mMidPoint = Diff;
-	NodeAIntersection.mMidPoint *= 0.5f;
-	NodeAIntersection.mMidPoint += a.mPosition;
-
-	//	copy to intersection B
-	NodeBIntersection.mDistance = -NodeAIntersection.mDistance;
-	NodeBIntersection.mMidPoint = NodeAIntersection.mMidPoint;
-	NodeBIntersection.mIntersection = NodeAIntersection.mOtherIntersection;
-	NodeBIntersection.mOtherIntersection = NodeAIntersection.mIntersection;
-	NodeBIntersection.mForceWeight = 1.f - NodeAIntersection.mForceWeight;
-
-	return true;
+	//	update velocity of every body
+	gPhysics.ApplyForces();
 }
 
-class TCollisionTest
+namespace TBroadphase
 {
-public:
-	TCollisionTest()
+	enum Type
 	{
-	}
-	TCollisionTest(TPhysicsObject& ObjectA,TPhysicsObject& ObjectB) :
-		mObjectA	( &ObjectA ),
-		mObjectB	( &ObjectB ),
-		mHit		( false )
+		BruteForce = 0,	//	every a<b pair
+		Grid,			//	uniform grid over the playfield, only neighbouring cells are paired
+		SweepAndPrune,	//	sweep along y, seeded with the sprite pool's depth order
+		ContactCache,	//	last frame's pairs, only players that have moved far enough are paired again
+	};
+};
+
+TBroadphase::Type gBroadphase = TBroadphase::ContactCache;
+
+BufferArray<TCollisionTest,MAX_COLLISION_TESTS> gCollisionTests;
+u16 gLostCollisionTests = 0;	//	pairs the broadphase had no room for this frame
+
+void AddCollisionTest(u16 BodyA,u16 BodyB)
+{
+	//	keep counting when we're full so the debug line shows what's being missed
+	if ( gCollisionTests.GetSize() >= gCollisionTests.MaxSize() )
 	{
+		gLostCollisionTests++;
+		return;
 	}
+	gCollisionTests.PushBack( TCollisionTest( BodyA, BodyB ) );
+}
+TNarrowphase gNarrowphase;
+TContactSolver gContactSolver;
+TContactCache gContactCache;
+
 
-	bool		IsValid() const		{	return mObjectA && mObjectB;	}
+//	uniform grid broadphase. Cells are at least as big as the largest collision diameter
+//	so anything that can touch is in the same or a neighbouring cell
+#define COLLISION_GRID_MAX_WIDTH	32
+#define COLLISION_GRID_MAX_HEIGHT	32
 
+class TCollisionGrid
+{
 public:
-	TPhysicsObject*	mObjectA;
-	TPhysicsObject*	mObjectB;
+	template<class ARRAY>	//	Array<TCollisionShape>
+	void		Build(const ARRAY& Shapes);
+	u16			GetCell(const TCollisionShape& Shape) const;
 
-	bool		mHit;				//	was hit?
-	
-	//TPointf		mHitPosition;		//	world space
-	//TPointf		mResponseForceA;	//	force to apply to object A
-	//TPointf		mResponseForceB;	//	force to apply to object A
-	TIntersection	mIntersectionA;
-	TIntersection	mIntersectionB;
+public:
+	u16									mCellSize;
+	u8									mWidth;
+	u8									mHeight;
+	BufferArray<u16,(COLLISION_GRID_MAX_WIDTH*COLLISION_GRID_MAX_HEIGHT)+1>	mCellFirst;		//	index into mCellObjects for each cell (+1 tail)
+	BufferArray<u8,256>					mCellObjects;	//	object indexes sorted by cell
+	BufferArray<u16,256>				mObjectCell;	//	cell of each object
 };
 
+u16 TCollisionGrid::GetCell(const TCollisionShape& Shape) const
+{
+	//	clamp anything off the playfield into the edge cells
+	int x = (Shape.mPosition.x < 0.f) ? 0 : TScalar::ToInt( Shape.mPosition.x ) / mCellSize;
+	int y = (Shape.mPosition.y < 0.f) ? 0 : TScalar::ToInt( Shape.mPosition.y ) / mCellSize;
+	x = min( x, mWidth-1 );
+	y = min( y, mHeight-1 );
+	return x + (y * mWidth);
+}
 
-void OnCollision(TPhysicsObject& Player,const TIntersection& Intersection)
+template<class ARRAY>
+void TCollisionGrid::Build(const ARRAY& Shapes)
 {
-	//	we want to move our intersection point up to the edge of where the other object intersected
-	TPointf Delta = Intersection.mOtherIntersection - Intersection.mIntersection;
+	//	size cells from the biggest shape
+	TPhysicsScalar MaxRadius = 0.f;
+	for ( int i=0;	i<Shapes.GetSize();	i++ )
+		MaxRadius = max( MaxRadius, Shapes[i].mRadius );
+
+	int MinCellSize = max( (PLAYFIELD_WIDTH+COLLISION_GRID_MAX_WIDTH-1) / COLLISION_GRID_MAX_WIDTH, (PLAYFIELD_HEIGHT+COLLISION_GRID_MAX_HEIGHT-1) / COLLISION_GRID_MAX_HEIGHT );
+	mCellSize = max( TScalar::ToInt( MaxRadius*2.f ) + 1 + BROADPHASE_MARGIN, MinCellSize );
+	mWidth = (PLAYFIELD_WIDTH + mCellSize - 1) / mCellSize;
+	mHeight = (PLAYFIELD_HEIGHT + mCellSize - 1) / mCellSize;
+	int CellCount = mWidth * mHeight;
+
+	//	counting sort objects into cells
+	mCellFirst.SetSize( CellCount+1 );
+	mCellFirst.SetAll( 0 );
+	mObjectCell.SetSize( Shapes.GetSize() );
+	for ( int i=0;	i<Shapes.GetSize();	i++ )
+	{
+		u16 Cell = GetCell( Shapes[i] );
+		mObjectCell[i] = Cell;
+		mCellFirst[Cell+1]++;
+	}
 
-	//	if the force weight is 1 then we don't move as all the power is on OUR side.
-	//	if it's zero, we take ALL the impact
-	Delta *= 1.f - Intersection.mForceWeight;
+	for ( int c=0;	c<CellCount;	c++ )
+		mCellFirst[c+1] += mCellFirst[c];
 
-	//	gr: should not be neccessary...
-	float Bounce = 10.f;
-	Delta*=1.f/Bounce;//0.5f;
+	//	fill in order, using each cell's first index as its write cursor
+	mCellObjects.SetSize( Shapes.GetSize() );
+	for ( int i=0;	i<Shapes.GetSize();	i++ )
+	{
+		u16 Cell = mObjectCell[i];
+		mCellObjects[ mCellFirst[Cell]++ ] = i;
+	}
 
-	//	change the movement delta if we're against a static object (so definately is moved)
-	//	if it's a soft object (not static) then change the velocity
-	//	gr: had to NEGATE this from tootle code... WHY???
-	Player.mForce -= Delta;
+	//	cursors have moved on to the next cell's first, shift them back
+	for ( int c=CellCount;	c>0;	c-- )
+		mCellFirst[c] = mCellFirst[c-1];
+	mCellFirst[0] = 0;
 }
 
 
-void DoCollision(TCollisionTest& CollisionTest)
+void Broadphase_BruteForce()
 {
-	CollisionTest.mHit = false;
-	if ( !CollisionTest.IsValid() )
-		return;
-	auto& ObjA = *CollisionTest.mObjectA;
-	auto& ObjB = *CollisionTest.mObjectB;
+	for ( int a=0;	a<gPlayers.GetSize();	a++ )
+	{
+		bool TestAgainstAllPlayers = true;
+		//	TestAgainstAllPlayers = ( gPlayer[a].CollisionShapeGoesOutsideSprite );
 
-	TCollisionShape ColShapeA = ObjA.GetWorldCollisionShape();
-	TCollisionShape ColShapeB = ObjB.GetWorldCollisionShape();
-	if ( !ColShapeA.IsValid() || !ColShapeB.IsValid() )
-		return;
+		if ( TestAgainstAllPlayers )
+		{
+			for ( int b=a+1;	b<gPlayers.GetSize();	b++ )
+			{
+				AddCollisionTest( gPlayers[a].mPlayerBody, gPlayers[b].mPlayerBody );
+				//gCollisionTests.PushBack( TCollisionTest( gPlayers[a].mGloveBody, gPlayers[b].mPlayerBody ) );
+				//gCollisionTests.PushBack( TCollisionTest( gPlayers[a].mPlayerBody, gPlayers[b].mGloveBody ) );
+			}
+		}
+	}
+}
 
-	if ( !GetIntersection( ColShapeA, ColShapeB, CollisionTest.mIntersectionA, CollisionTest.mIntersectionB, ObjA, ObjB ) )
-		return;
+void Broadphase_Grid(const BufferArray<TCollisionShape,256>& Shapes)
+{
+	static TCollisionGrid Grid;
+	Grid.Build( Shapes );
 
-	/*
-	//	get the mid-collision point
-	float TotalRadius = ColShapeA.mRadius + ColShapeB.mRadius;
-	float TotalRadiusSq = TotalRadius*TotalRadius;
-	TPointf DirectionAB = ColShapeB.mPosition;
-	DirectionAB -= ColShapeA.mPosition;
-	float DistanceSq = DirectionAB.GetLengthSq();
-	if ( DistanceSq > TotalRadiusSq )
-		return;
-	*/
-	CollisionTest.mHit = true;
-
-	OnCollision( ObjA, CollisionTest.mIntersectionA );
-	OnCollision( ObjB, CollisionTest.mIntersectionB );
-
-
-	/*
-	//	work out intersection point
-	float DistanceWeightA = ColShapeA.mRadius / TotalRadius;
-	float DistanceWeightB = 1.f - DistanceWeightA;
-	CollisionTest.mHitPosition = ColShapeA.mPosition;
-	CollisionTest.mHitPosition += DirectionAB * DistanceWeightA;
-	float Overlap = -(DirectionAB.GetLength() - TotalRadius);
-	assert( Overlap >= 0.f, "expected overlap to be positive" );
-
-	TPointf DirectionABNormal = DirectionAB;
-	DirectionABNormal.Normalise();
-
-	//	move objects away from each other so they don't overlap
-	TPointf MoveA = CollisionTest.mHitPosition - (DirectionABNormal*(Overlap));
-	MoveA -= ColShapeA.mPosition;
-	TPointf MoveB = CollisionTest.mHitPosition + (DirectionABNormal*(Overlap));
-	MoveB -= ColShapeB.mPosition;
-
-	ObjA.mPosition += MoveA;
-	ObjB.mPosition += MoveB;
-	/*
-	//	basic amount to move objects away (this should NOT be velocity and instead a position change!)
-	float BasicForce = 0.01f;
-
-	//	push objects away from each other
-	DirectionAB.Normalise();
-	float PowerA = ObjA.mVelocity.GetLength();
-	float PowerB = ObjB.mVelocity.GetLength();
-	CollisionTest.mResponseForceA = DirectionAB * -(DistanceWeightA + PowerB);
-	CollisionTest.mResponseForceB = DirectionAB * (DistanceWeightB + PowerA);
-
-	//	apply to objects
-	ObjA.mVelocity += CollisionTest.mResponseForceA;
-	ObjB.mVelocity += CollisionTest.mResponseForceB;
-	*/
+	BufferArray<u8,256> Neighbours;
+	for ( int a=0;	a<Shapes.GetSize();	a++ )
+	{
+		u16 Cell = Grid.mObjectCell[a];
+		int cx = Cell % Grid.mWidth;
+		int cy = Cell / Grid.mWidth;
+
+		//	gather higher-indexed objects in the 3x3 cells around us
+		Neighbours.Clear();
+		for ( int y=max(cy-1,0);	y<=min(cy+1,Grid.mHeight-1);	y++ )
+		{
+			for ( int x=max(cx-1,0);	x<=min(cx+1,Grid.mWidth-1);	x++ )
+			{
+				u16 NeighbourCell = x + (y * Grid.mWidth);
+				for ( int n=Grid.mCellFirst[NeighbourCell];	n<Grid.mCellFirst[NeighbourCell+1];	n++ )
+				{
+					u8 b = Grid.mCellObjects[n];
+					if ( b <= a )
+						continue;
+
+					//	cells are bigger than the shapes, so prune the corners too
+					TPhysicsScalar TotalRadius = Shapes[a].mRadius + Shapes[b].mRadius + BROADPHASE_MARGIN;
+					TPhysicsScalar DiffX = Shapes[b].mPosition.x - Shapes[a].mPosition.x;
+					TPhysicsScalar DiffY = Shapes[b].mPosition.y - Shapes[a].mPosition.y;
+					if ( DiffX > TotalRadius || DiffX < -TotalRadius || DiffY > TotalRadius || DiffY < -TotalRadius )
+						continue;
+
+					//	insert sorted so pairs come out in the same order as the brute force loop
+					Neighbours.PushBack( b );
+					for ( int i=Neighbours.GetTailIndex();	i>0 && Neighbours[i-1] > Neighbours[i];	i-- )
+					{
+						u8 Temp = Neighbours[i-1];
+						Neighbours[i-1] = Neighbours[i];
+						Neighbours[i] = Temp;
+					}
+				}
+			}
+		}
+
+		for ( int i=0;	i<Neighbours.GetSize();	i++ )
+			AddCollisionTest( gPlayers[a].mPlayerBody, gPlayers[Neighbours[i]].mPlayerBody );
+	}
 }
 
+//	sort pair keys (a<<8 | b) with two 8 bit counting sort passes
+template<class ARRAY>
+void SortPairKeys(ARRAY& Keys,ARRAY& Temp)
+{
+	Temp.SetSize( Keys.GetSize() );
+	for ( int Shift=0;	Shift<16;	Shift+=8 )
+	{
+		ARRAY& From = (Shift == 0) ? Keys : Temp;
+		ARRAY& To = (Shift == 0) ? Temp : Keys;
+
+		u16 First[256+1];
+		for ( int i=0;	i<256+1;	i++ )
+			First[i] = 0;
+		for ( int i=0;	i<From.GetSize();	i++ )
+			First[ ((From[i] >> Shift) & 0xff) + 1 ]++;
+		for ( int i=0;	i<256;	i++ )
+			First[i+1] += First[i];
+		for ( int i=0;	i<From.GetSize();	i++ )
+			To[ First[(From[i] >> Shift) & 0xff]++ ] = From[i];
+	}
+}
 
-void Update_Input()
+void Broadphase_SweepAndPrune(const BufferArray<TCollisionShape,256>& Shapes)
 {
-	float InputForce = 0.6f;
+	//	which player owns each sprite
+	BufferArray<u8,256> SpritePlayer( 256 );
+	SpritePlayer.SetAll( 0xff );
+	for ( int p=0;	p<gPlayers.GetSize();	p++ )
+	{
+		if ( gPlayers[p].mPlayerSpriteRef.IsValid() )
+			SpritePlayer[ gPlayers[p].mPlayerSpriteRef.GetIndex() ] = p;
+	}
 
-	//	update input
+	//	the sprite pool already keeps sprites sorted by y (last frame's positions) so start from
+	//	that order, and anything without a sprite goes on the end
+	BufferArray<u8,256> Order;
+	BufferArray<bool,256> Ordered( gPlayers.GetSize() );
+	Ordered.SetAll( false );
+	for ( int d=0;	d<gSpritePool.GetSpriteCount();	d++ )
+	{
+		u8 p = SpritePlayer[ gSpritePool.GetDepthOrderSprite(d).GetIndex() ];
+		if ( p == 0xff )
+			continue;
+		Order.PushBack( p );
+		Ordered[p] = true;
+	}
 	for ( int p=0;	p<gPlayers.GetSize();	p++ )
 	{
-		auto& Player = gPlayers[p];
-		Player.mInput.Update();
+		if ( !Ordered[p] )
+			Order.PushBack( p );
+	}
 
-		//	get direction vector
-		TPointf InputDirection = Player.mInput.GetDirectionVector();
-		InputDirection *= InputForce;
-		
-		//	apply input
-		Player.mPlayerPhysics.mForce += InputDirection;
+	//	insertion sort onto the shapes' top edge. Things have only moved a little since the
+	//	sprites were sorted, so this is close to linear
+	for ( int i=1;	i<Order.GetSize();	i++ )
+	{
+		u8 p = Order[i];
+		TPhysicsScalar MinY = Shapes[p].mPosition.y - Shapes[p].mRadius;
+		int j = i;
+		for ( ;	j>0 && (Shapes[Order[j-1]].mPosition.y - Shapes[Order[j-1]].mRadius) > MinY;	j-- )
+			Order[j] = Order[j-1];
+		Order[j] = p;
 	}
-}
 
-void Update_PhysicsPreUpdate()
-{
-	for ( int p=0;	p<gPlayers.GetSize();	p++ )
+	//	sweep down, pairing with everything whose y range starts before ours ends
+	static BufferArray<u16,MAX_COLLISION_TESTS> PairKeys;
+	static BufferArray<u16,MAX_COLLISION_TESTS> PairKeysTemp;
+	PairKeys.Clear();
+	for ( int i=0;	i<Order.GetSize();	i++ )
 	{
-		auto& Player = gPlayers[p];
+		const TCollisionShape& a = Shapes[Order[i]];
+		TPhysicsScalar MaxY = a.mPosition.y + a.mRadius + BROADPHASE_MARGIN;
+		for ( int j=i+1;	j<Order.GetSize();	j++ )
+		{
+			const TCollisionShape& b = Shapes[Order[j]];
+			if ( b.mPosition.y - b.mRadius > MaxY )
+				break;
+
+			//	prune on x too
+			TPhysicsScalar TotalRadius = a.mRadius + b.mRadius + BROADPHASE_MARGIN;
+			TPhysicsScalar DiffX = b.mPosition.x - a.mPosition.x;
+			if ( DiffX > TotalRadius || DiffX < -TotalRadius )
+				continue;
 
-		//	update velocity
-		Player.mPlayerPhysics.mVelocity += Player.mPlayerPhysics.mForce;
-		Player.mPlayerPhysics.mForce = TPointf(0,0);
+			if ( PairKeys.GetSize() >= PairKeys.MaxSize() )
+			{
+				gLostCollisionTests++;
+				continue;
+			}
 
-		//	try and position glove here relative to our direction
-		//	spring distance of glove to desired length
-		//	this is for movement, when rotating, and after our glove has been pushed out of place
+			u8 PlayerA = min( Order[i], Order[j] );
+			u8 PlayerB = max( Order[i], Order[j] );
+			PairKeys.PushBack( (PlayerA << 8) | PlayerB );
+		}
+	}
 
-		//	update velocity
-		Player.mGlovePhysics.mVelocity += Player.mGlovePhysics.mForce;
-		Player.mGlovePhysics.mForce = TPointf(0,0);
+	//	emit in the same order as the brute force loop
+	SortPairKeys( PairKeys, PairKeysTemp );
+	for ( int i=0;	i<PairKeys.GetSize();	i++ )
+	{
+		u8 a = PairKeys[i] >> 8;
+		u8 b = PairKeys[i] & 0xff;
+		AddCollisionTest( gPlayers[a].mPlayerBody, gPlayers[b].mPlayerBody );
 	}
 }
 
 void Update_Collisions(TFrameDebug& Debug)
 {
-	int CollisionIterationCount = 1;
-	BufferArray<TCollisionTest,100> CollisionTests;
+	u32 StartTime = micros();
+	BufferArray<TCollisionTest,MAX_COLLISION_TESTS>& CollisionTests = gCollisionTests;
+	gLostCollisionTests = 0;
 
-	//	generate collision tests
-	//	(shorten this test list using the hardware collision - assuming a collision shape doesn't go outside)
-	for ( int a=0;	a<gPlayers.GetSize();	a++ )
+	if ( gBroadphase == TBroadphase::ContactCache )
 	{
-		bool TestAgainstAllPlayers = true;
-		//	TestAgainstAllPlayers = ( gPlayer[a].CollisionShapeGoesOutsideSprite );
+		BufferArray<u16,256> Bodies;
+		for ( int p=0;	p<gPlayers.GetSize();	p++ )
+			Bodies.PushBack( gPlayers[p].mPlayerBody );
+
+		//	the cache keeps its pairs in the collision tests from last frame, pair up the players that
+		//	have moved, then re-test everything
+		u16 CachedCount = CollisionTests.GetSize();
+		CollisionTests.SetSize( CollisionTests.MaxSize() );
+		CollisionTests.SetSize( gContactCache.Update( gPhysics, &CollisionTests[0], CachedCount, CollisionTests.MaxSize(), Bodies.GetData(), Bodies.GetSize(), BROADPHASE_MARGIN ) );
+		gLostCollisionTests = gContactCache.mLostPairs;
+		if ( !CollisionTests.IsEmpty() )
+			gContactCache.DoCollisions( gPhysics, gNarrowphase, &CollisionTests[0], CollisionTests.GetSize(), BROADPHASE_MARGIN );
+	}
+	else
+	{
+		CollisionTests.Clear();
 
-		if ( TestAgainstAllPlayers )
+		//	world shapes for the broadphase
+		BufferArray<TCollisionShape,256> Shapes;
+		for ( int p=0;	p<gPlayers.GetSize();	p++ )
+			Shapes.PushBack( gPlayers[p].GetPlayerWorldCollisionShape() );
+
+		//	generate collision tests
+		//	(shorten this test list using the hardware collision - assuming a collision shape doesn't go outside)
+		switch ( gBroadphase )
 		{
-			for ( int b=a+1;	b<gPlayers.GetSize();	b++ )
-			{
-				CollisionTests.PushBack( TCollisionTest( gPlayers[a].mPlayerPhysics, gPlayers[b].mPlayerPhysics ) );
-				//CollisionTests.PushBack( TCollisionTest( gPlayers[a].mGlovePhysics, gPlayers[b].mPlayerPhysics ) );
-				//CollisionTests.PushBack( TCollisionTest( gPlayers[a].mPlayerPhysics, gPlayers[b].mGlovePhysics ) );
-			}
+		case TBroadphase::BruteForce:	Broadphase_BruteForce();			break;
+		case TBroadphase::Grid:			Broadphase_Grid( Shapes );			break;
+		case TBroadphase::SweepAndPrune:	Broadphase_SweepAndPrune( Shapes );	break;
+		default:	break;
 		}
+
+		//	batch reject the pairs that are too far apart, full contacts for the rest
+		if ( !CollisionTests.IsEmpty() )
+			gNarrowphase.DoCollisions( gPhysics, &CollisionTests[0], CollisionTests.GetSize(), BROADPHASE_MARGIN );
 	}
 
 	//	execute collision tests
 	//	track which collision tests to re-execute for multiple iterations
-	BufferArray<u16,100> IterateCollisionTests;
-
+	BufferArray<u16,MAX_COLLISION_TESTS> IterateCollisionTests;
 	for ( int c=0;	c<CollisionTests.GetSize();	c++ )
 	{
 		TCollisionTest& CollisionTest = CollisionTests[c];
-		DoCollision( CollisionTest );
 		if ( !CollisionTest.mHit )
 			continue;
 	
@@ -666,48 +701,63 @@ void Update_Collisions(TFrameDebug& Debug)
 		IterateCollisionTests.PushBack( c );
 	}
 
+	//	push crowds apart over a few more iterations, only where contacts are still deep
+	if ( !IterateCollisionTests.IsEmpty() )
+		gContactSolver.Solve( gPhysics, &CollisionTests[0], IterateCollisionTests.GetData(), IterateCollisionTests.GetSize() );
+
 	//	note number of collisions
 	auto& DebugString = Debug.PushBackString();
-	DebugString << "Collision count: " << IterateCollisionTests.GetSize();
-	/*
-	//	multiple iterations
-	for ( int Iteration=0;	!IterateCollisionTests.IsEmpty() && Iteration<CollisionIterationCount;	Iteration++ )
+	DebugString << "Collision count: " << IterateCollisionTests.GetSize() << " isl " << gContactSolver.mIslandCount << " it " << gContactSolver.mIterationCount << "/" << gContactSolver.mTestCount << "    ";
+
+	u32 Duration = micros() - StartTime;
+	auto& PairString = Debug.PushBackString();
+	PairString << "Pairs: " << CollisionTests.GetSize() << " " << static_cast<int>( Duration ) << "us ";
+	if ( gLostCollisionTests > 0 )
+		PairString << "lost " << gLostCollisionTests;
+	PairString << "          ";
+
+	//	cycles per pair to compare float and fixed point physics on the arduino
+	auto& MathsString = Debug.PushBackString();
+	MathsString << (MONKEYFIGHT_FIXED_PHYSICS ? "Fixed: " : "Float: ");
+#if defined(clockCyclesPerMicrosecond)
+	u32 Cycles = Duration * clockCyclesPerMicrosecond();
+	MathsString << static_cast<int>( CollisionTests.IsEmpty() ? 0 : Cycles / CollisionTests.GetSize() ) << "cyc/pair    ";
+#else
+	MathsString << static_cast<int>( Duration ) << "us    ";
+#endif
+
+	//	how much of the contact cache carried over. hit is contacts that needed no pairing this frame,
+	//	warm is contacts that reused last frame's intersection, wait is pairs only in the skin that there
+	//	wasn't room for this frame
+	if ( gBroadphase == TBroadphase::ContactCache )
 	{
-		for ( int i=IterateCollisionTests.GetTailIndex();	i>=0;	i-- )
-		{
-			int CollisionTestIndex = IterateCollisionTests[i];
-			TCollisionTest& CollisionTest = CollisionTests[CollisionTestIndex];
-			DoCollision( CollisionTest );
-
-			//	remove collision from iteration list if nothing happened
-			
-			//if ( !CollisionTest.mHit )
-			//	IterateCollisionTests.RemoveAt( i );
-		}
+		u16 Hits = max( gContactCache.mHitCount, 1 );
+		auto& CacheString = Debug.PushBackString();
+		CacheString << "Cache: " << static_cast<int>( (static_cast<u32>( gContactCache.mCachedHits ) * 100) / Hits ) << "% hit ";
+		CacheString << static_cast<int>( (static_cast<u32>( gContactCache.mReusedHits ) * 100) / Hits ) << "% warm ";
+		CacheString << gContactCache.mMovedBodies << "mv " << gContactCache.mNewPairs << "new ";
+		if ( gContactCache.mDeferredPairs > 0 )
+			CacheString << gContactCache.mDeferredPairs << "wait";
+		CacheString << "          ";
 	}
-	*/
 }
 
 
 
 void Update_PhysicsPostUpdate()
 {
-	float PlayerFriction = 0.3f;
-	float GloveFriction = 0.6f;
+	gPhysics.Integrate();
 
 	//	move sprites around
 	for ( int p=0;	p<gPlayers.GetSize();	p++ )
 	{
 		auto& Player = gPlayers[p];
 		
-		Player.mPlayerPhysics.PostUpdate( PlayerFriction );
-		Player.mGlovePhysics.PostUpdate( GloveFriction );
-		
 		//	update sprites
-		Player.mPlayerSpriteInfo.mPosition.x = Player.GetPlayerPosition().x + Player.mPlayerSpriteOffset.x;
-		Player.mPlayerSpriteInfo.mPosition.y = Player.GetPlayerPosition().y + Player.mPlayerSpriteOffset.y;
-		Player.mGloveSpriteInfo.mPosition.x = Player.GetGlovePosition().x;
-		Player.mGloveSpriteInfo.mPosition.y = Player.GetGlovePosition().y;
+		Player.mPlayerSpriteInfo.mPosition.x = TScalar::ToInt( Player.GetPlayerPosition().x + Player.mPlayerSpriteOffset.x );
+		Player.mPlayerSpriteInfo.mPosition.y = TScalar::ToInt( Player.GetPlayerPosition().y + Player.mPlayerSpriteOffset.y );
+		Player.mGloveSpriteInfo.mPosition.x = TScalar::ToInt( Player.GetGlovePosition().x );
+		Player.mGloveSpriteInfo.mPosition.y = TScalar::ToInt( Player.GetGlovePosition().y );
 		gSpritePool.MoveSprite( Player.mPlayerSpriteRef, Player.mPlayerSpriteInfo.mPosition );
 	//	gSpritePool.MoveSprite( Player.mGloveSpriteRef, Player.mGloveSpriteInfo.mPosition );
 	}
@@ -716,6 +766,7 @@ void Update_PhysicsPostUpdate()
 
 void TGame::Update()
 {
+	u32 FrameStart = micros();
 	TFrameDebug Debug;
 
 	Update_Input();
@@ -727,14 +778,30 @@ void TGame::Update()
 	
 	gSpritePool.BakeHardwareChanges( Debug );
 
+	auto& BusString = Debug.PushBackString();
+	BusString << "SPI: " << gLastFrameBusStats.mTransactions << "tx " << gLastFrameBusStats.mBytes << "b/" << gLastFrameBusStats.mQueuedBytes << "q    ";
+
 	for ( int i=0;	i<Debug.GetMaxLineCount();	i++ )
 	{
 		//	clear line
-		GD.putstr( 0, i, "                 " );
+		TGameDuino::PutString( 0, i, "                 " );
 		if ( i < Debug.mStrings.GetSize() ) 
-			GD.putstr( 0, i, Debug.mStrings[i] );
+			TGameDuino::PutString( 0, i, Debug.mStrings[i] );
 	}
 
+	//	spend what's left of the frame loading sprite images
+	gSpriteImages.StreamImages( FrameStart + FRAME_TIME_US - FRAME_FLUSH_RESERVE_US, SPRITE_IMAGE_STREAM_BYTES );
+}
+
+void TGame::OnVBlank()
+{
+	//	send this frame's writes, then show the sprite page we baked into
+	gSpritePalettes.Flush();
+	TGameDuino::FlushWrites();
+	gSpritePool.FlipHardwarePages();
+
+	gLastFrameBusStats = TGameDuino::GetBusStats();
+	TGameDuino::ResetBusStats();
 }
 
 
@@ -6,5 +6,6 @@ class TGame
 public:
 	void		Init();
 	void		Update();
+	void		OnVBlank();		//	keep this short, it's all the time we get before the frame is drawn
 };
 
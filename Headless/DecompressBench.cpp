@@ -0,0 +1,93 @@
+//	times TVramDecompressor on the compressed assets against GD.uncompress, checks they output the
+//	same thing, and reports the memory the decompressor needs. Build from the repository root with
+//		g++ -std=c++11 -O2 -IHeadless -I. Headless/DecompressBench.cpp Headless/GD.cpp TGuts.cpp -o decompress_bench
+//	usage: decompress_bench [bytes per Decompress() call] [repeats]
+#include "GD.h"
+#include "TGuts.h"
+#include "monkeyfightgraphics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+	class TAsset
+	{
+	public:
+		const char*		mName;
+		prog_uchar*		mData;
+		u16				mDataSize;
+		u16				mDestAddr;
+	};
+
+	//	returns bytes output
+	u32 DecompressStreamed(const TAsset& Asset,u16 ChunkSize,u32& Calls)
+	{
+		TVramDecompressor Decompressor;
+		Decompressor.Begin( Asset.mData, Asset.mDestAddr );
+		u32 Size = 0;
+		while ( !Decompressor.IsFinished() )
+		{
+			//	one call per frame, sent at vblank
+			Size += Decompressor.Decompress( ChunkSize );
+			TGameDuino::FlushWrites();
+			Calls++;
+		}
+		return Size;
+	}
+}
+
+int main(int argc,char* argv[])
+{
+	u16 ChunkSize = (argc > 1) ? atoi( argv[1] ) : 256;
+	int Repeats = (argc > 2) ? atoi( argv[2] ) : 20;
+
+	TAsset Assets[] =
+	{
+		{	"asteroid_images",	asteroid_images_compressed,	sizeof(asteroid_images_compressed),	RAM_SPRIMG	},
+		{	"bg_chr",			bg_chr_compressed,			sizeof(bg_chr_compressed),			RAM_CHR		},
+		{	"bg_pal",			bg_pal_compressed,			sizeof(bg_pal_compressed),			RAM_PAL		},
+	};
+
+	GD.begin();
+	static u8 Expected[GD_RAM_SIZE];
+	bool AllMatch = true;
+
+	printf( "%u bytes per call, scratch %u bytes (TVramDecompressor) + %u bytes queued per call\n", ChunkSize, static_cast<unsigned>( sizeof(TVramDecompressor) ), static_cast<unsigned>( min( ChunkSize, GD_DECOMPRESS_WINDOW ) ) );
+	for ( size_t a=0;	a<sizeof(Assets)/sizeof(Assets[0]);	a++ )
+	{
+		const TAsset& Asset = Assets[a];
+
+		//	GD.uncompress, a transaction per byte plus a read back for every back referenced byte
+		GD.fill( 0, 0, GD_RAM_SIZE );
+		THeadless::ResetStats();
+		unsigned long StartTime = micros();
+		for ( int r=0;	r<Repeats;	r++ )
+			GD.uncompress( Asset.mDestAddr, Asset.mData );
+		unsigned long ReferenceTime = micros() - StartTime;
+		unsigned long ReferenceTransactions = THeadless::GetStats().mTransactions / Repeats;
+		memcpy( Expected, THeadless::GetRam(), GD_RAM_SIZE );
+
+		GD.fill( 0, 0, GD_RAM_SIZE );
+		THeadless::ResetStats();
+		u32 Size = 0;
+		u32 Calls = 0;
+		StartTime = micros();
+		for ( int r=0;	r<Repeats;	r++ )
+			Size = DecompressStreamed( Asset, ChunkSize, Calls );
+		unsigned long StreamedTime = micros() - StartTime;
+		unsigned long StreamedTransactions = THeadless::GetStats().mTransactions / Repeats;
+
+		bool Match = ( memcmp( Expected, THeadless::GetRam(), GD_RAM_SIZE ) == 0 );
+		AllMatch = AllMatch && Match;
+
+		double Megabytes = static_cast<double>( Size ) * Repeats / (1024.0*1024.0);
+		printf( "%-16s %5u -> %5u bytes in %3lu calls: %7.1fMB/s %5lu transactions (GD.uncompress %7.1fMB/s %5lu transactions) %s\n",
+			Asset.mName, Asset.mDataSize, static_cast<unsigned>( Size ), static_cast<unsigned long>( Calls / Repeats ),
+			Megabytes / (StreamedTime / 1000000.0), StreamedTransactions,
+			Megabytes / (ReferenceTime / 1000000.0), ReferenceTransactions,
+			Match ? "ok" : "MISMATCH" );
+	}
+
+	return AllMatch ? 0 : 1;
+}
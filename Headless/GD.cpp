@@ -0,0 +1,328 @@
+//	system headers first, GD.h defines arduino's min/max macros
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <thread>
+#include "GD.h"
+#include "SPI.h"
+
+GDClass GD;
+SPIClass SPI;
+
+namespace THeadless
+{
+	uint8_t		gRam[GD_RAM_SIZE];
+	unsigned int	gAddr = 0;			//	current SPI address
+	bool		gWriting = false;	//	__wstart'd rather than __start'd
+	TStats		gStats;
+	uint8_t		gButtonsDown = 0;
+};
+
+
+const uint8_t* THeadless::GetRam()
+{
+	return gRam;
+}
+
+const THeadless::TStats& THeadless::GetStats()
+{
+	return gStats;
+}
+
+void THeadless::ResetStats()
+{
+	gStats = TStats();
+}
+
+void THeadless::SetButtons(uint8_t PinsDown)
+{
+	gButtonsDown = PinsDown;
+}
+
+void THeadless::Abort(const char* Error,const char* Function)
+{
+	fprintf( stderr, "Assert! %s in function: %s\n", Error, Function );
+	exit( 1 );
+}
+
+
+unsigned long micros()
+{
+	using namespace std::chrono;
+	static steady_clock::time_point Start = steady_clock::now();
+	return static_cast<unsigned long>( duration_cast<microseconds>( steady_clock::now() - Start ).count() );
+}
+
+unsigned long millis()
+{
+	return micros() / 1000;
+}
+
+void delay(unsigned long Milliseconds)
+{
+	std::this_thread::sleep_for( std::chrono::milliseconds( Milliseconds ) );
+}
+
+int digitalRead(uint8_t Pin)
+{
+	//	buttons pull low when pressed
+	return ( THeadless::gButtonsDown & (1<<Pin) ) ? LOW : HIGH;
+}
+
+
+uint8_t SPIClass::transfer(uint8_t Data)
+{
+	using namespace THeadless;
+	uint8_t& Ram = gRam[ gAddr & (GD_RAM_SIZE-1) ];
+	gAddr++;
+	if ( !gWriting )
+		return Ram;
+
+	Ram = Data;
+	gStats.mBytes++;
+	return 0;
+}
+
+
+void GDClass::begin()
+{
+	//	same state the real begin() leaves: blank screen, all 512 sprites hidden
+	memset( THeadless::gRam, 0, sizeof(THeadless::gRam) );
+	wr( IDENT, 0x6d );
+	fill( RAM_PIC, 0, 1024*10 );
+	__wstart( RAM_SPR );
+	for ( int i=0;	i<512;	i++ )
+		GD.xhide();
+	__end();
+	GD.spr = 0;
+}
+
+void GDClass::end()
+{
+}
+
+void GDClass::__start(unsigned int Addr)
+{
+	THeadless::gAddr = Addr;
+	THeadless::gWriting = false;
+}
+
+void GDClass::__wstart(unsigned int Addr)
+{
+	THeadless::gAddr = Addr;
+	THeadless::gWriting = true;
+	THeadless::gStats.mTransactions++;
+	THeadless::gStats.mBytes += 2;
+}
+
+void GDClass::__end()
+{
+	THeadless::gWriting = false;
+}
+
+uint8_t GDClass::rd(unsigned int Addr)
+{
+	__start( Addr );
+	uint8_t r = SPI.transfer( 0 );
+	__end();
+	return r;
+}
+
+void GDClass::wr(unsigned int Addr,uint8_t v)
+{
+	__wstart( Addr );
+	SPI.transfer( v );
+	__end();
+}
+
+unsigned int GDClass::rd16(unsigned int Addr)
+{
+	__start( Addr );
+	unsigned int r = SPI.transfer( 0 );
+	r |= SPI.transfer( 0 ) << 8;
+	__end();
+	return r;
+}
+
+void GDClass::wr16(unsigned int Addr,unsigned int v)
+{
+	__wstart( Addr );
+	SPI.transfer( lowByte(v) );
+	SPI.transfer( highByte(v) );
+	__end();
+}
+
+void GDClass::fill(int Addr,uint8_t v,unsigned int Count)
+{
+	__wstart( Addr );
+	while ( Count-- )
+		SPI.transfer( v );
+	__end();
+}
+
+void GDClass::copy(unsigned int Addr,const prog_uchar* Src,int Count)
+{
+	__wstart( Addr );
+	while ( Count-- )
+		SPI.transfer( pgm_read_byte( Src++ ) );
+	__end();
+}
+
+void GDClass::setpal(int Pal,unsigned int Rgb)
+{
+	wr16( RAM_PAL + (Pal << 1), Rgb );
+}
+
+void GDClass::sprite(int Spr,int x,int y,uint8_t Image,uint8_t Palette,uint8_t Rot,uint8_t Jk)
+{
+	__wstart( RAM_SPR + (Spr << 2) );
+	SPI.transfer( lowByte(x) );
+	SPI.transfer( (Palette << 4) | (Rot << 1) | (highByte(x) & 1) );
+	SPI.transfer( lowByte(y) );
+	SPI.transfer( (Jk << 7) | (Image << 1) | (highByte(y) & 1) );
+	__end();
+}
+
+void GDClass::sprite2x2(int Spr,int x,int y,uint8_t Image,uint8_t Palette,uint8_t Rot,uint8_t Jk)
+{
+	__wstart( RAM_SPR + (Spr << 2) );
+	GD.xsprite( x, y, -16, -16, Image+0, Palette, Rot, Jk );
+	GD.xsprite( x, y,   0, -16, Image+1, Palette, Rot, Jk );
+	GD.xsprite( x, y, -16,   0, Image+2, Palette, Rot, Jk );
+	GD.xsprite( x, y,   0,   0, Image+3, Palette, Rot, Jk );
+	__end();
+}
+
+void GDClass::waitvblank()
+{
+	//	no display to wait for
+	THeadless::gRam[FRAME]++;
+	THeadless::gStats.mFrames++;
+}
+
+void GDClass::ascii()
+{
+	//	no font data here, but write as much as the real one does
+	for ( int c=' ';	c<0x80;	c++ )
+	{
+		setpal( 4*c+0, TRANSPARENT );
+		setpal( 4*c+3, RGB(255,255,255) );
+	}
+	fill( RAM_CHR + (' ' * 16), 0, (0x80-' ') * 16 );
+	fill( RAM_PIC, ' ', 4096 );
+}
+
+void GDClass::putstr(int x,int y,const char* String)
+{
+	__wstart( RAM_PIC + (y << 6) + x );
+	while ( *String )
+		SPI.transfer( *String++ );
+	__end();
+}
+
+void GDClass::voice(int v,uint8_t Wave,unsigned int Freq,uint8_t LAmp,uint8_t RAmp)
+{
+	__wstart( VOICES + (v << 2) );
+	SPI.transfer( lowByte(Freq) );
+	SPI.transfer( highByte(Freq) | (Wave << 7) );
+	SPI.transfer( LAmp );
+	SPI.transfer( RAmp );
+	__end();
+}
+
+void GDClass::screenshot(unsigned int)
+{
+	//	the real one streams the screen over serial, nothing's listening headless
+}
+
+void GDClass::xsprite(int ox,int oy,signed char x,signed char y,uint8_t Image,uint8_t Palette,uint8_t Rot,uint8_t Jk)
+{
+	//	expects to be inside a __wstart() at the sprite
+	if ( Rot & 2 )
+		x = -16-x;
+	if ( Rot & 4 )
+		y = -16-y;
+	if ( Rot & 1 )
+	{
+		signed char s = x;
+		x = y;
+		y = s;
+	}
+	ox += x;
+	oy += y;
+	SPI.transfer( lowByte(ox) );
+	SPI.transfer( (Palette << 4) | (Rot << 1) | (highByte(ox) & 1) );
+	SPI.transfer( lowByte(oy) );
+	SPI.transfer( (Jk << 7) | (Image << 1) | (highByte(oy) & 1) );
+	spr++;
+}
+
+void GDClass::xhide()
+{
+	SPI.transfer( lowByte(400) );
+	SPI.transfer( highByte(400) );
+	SPI.transfer( lowByte(400) );
+	SPI.transfer( highByte(400) );
+	spr++;
+}
+
+namespace
+{
+	//	fields are most significant bit first, bytes are read from the bottom bit up
+	class TBitstream
+	{
+	public:
+		TBitstream(const prog_uchar* Src) :
+			mSrc	( Src ),
+			mMask	( 0x1 )
+		{
+		}
+
+		unsigned int	GetBits(int Count)
+		{
+			unsigned int Bits = 0;
+			while ( Count-- )
+			{
+				Bits <<= 1;
+				if ( pgm_read_byte( mSrc ) & mMask )
+					Bits |= 1;
+				mMask <<= 1;
+				if ( mMask == 0 )
+				{
+					mMask = 0x1;
+					mSrc++;
+				}
+			}
+			return Bits;
+		}
+
+	public:
+		const prog_uchar*	mSrc;
+		uint8_t				mMask;
+	};
+}
+
+void GDClass::uncompress(unsigned int Addr,prog_uchar* Src)
+{
+	//	same as the gameduino library; back references are read back from gameduino ram
+	TBitstream Bits( Src );
+	int OffsetBits = Bits.GetBits( 4 );
+	int LengthBits = Bits.GetBits( 4 );
+	int MinLength = Bits.GetBits( 2 );
+	unsigned int Items = Bits.GetBits( 16 );
+	while ( Items-- )
+	{
+		if ( Bits.GetBits( 1 ) == 0 )
+		{
+			wr( Addr++, Bits.GetBits( 8 ) );
+			continue;
+		}
+		int Offset = -static_cast<int>( Bits.GetBits( OffsetBits ) ) - 1;
+		int Length = Bits.GetBits( LengthBits ) + MinLength;
+		while ( Length-- )
+		{
+			wr( Addr, rd( Addr + Offset ) );
+			Addr++;
+		}
+	}
+}
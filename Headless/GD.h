@@ -0,0 +1,132 @@
+#pragma once
+//	headless stand-in for the Gameduino library (and the bits of arduino it uses)
+//	every write lands in a shadow copy of the gameduino's 32k address space and is counted,
+//	nothing is drawn. See HeadlessMain.cpp
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+#include <string.h>
+
+#define GD_HEADLESS
+
+//	arduino
+typedef uint8_t			byte;
+typedef unsigned char	prog_uchar;
+#define PROGMEM
+#define HIGH			1
+#define LOW				0
+#define lowByte(w)		((uint8_t)((w) & 0xff))
+#define highByte(w)		((uint8_t)((w) >> 8))
+#define pgm_read_byte(p)	(*(const uint8_t*)(p))
+#define pgm_read_word(p)	(*(const uint16_t*)(p))
+
+unsigned long	micros();
+unsigned long	millis();
+void			delay(unsigned long Milliseconds);
+int				digitalRead(uint8_t Pin);
+
+//	gameduino memory map
+#define RAM_PIC		0x0000
+#define RAM_CHR		0x1000
+#define RAM_PAL		0x2000
+#define IDENT		0x2800
+#define REV			0x2801
+#define FRAME		0x2802
+#define VBLANK		0x2803
+#define SCROLL_X	0x2804
+#define SCROLL_Y	0x2806
+#define JK_MODE		0x2808
+#define J1_RESET	0x2809
+#define SPR_DISABLE	0x280a
+#define SPR_PAGE	0x280b
+#define IOMODE		0x280c
+#define BG_COLOR	0x280e
+#define SAMPLE_L	0x2810
+#define SAMPLE_R	0x2812
+#define MODULATOR	0x2814
+#define VIDEO_MODE	0x2815
+#define SCREENSHOT_Y	0x281e
+#define PALETTE16A	0x2840
+#define PALETTE16B	0x2860
+#define PALETTE4A	0x2880
+#define PALETTE4B	0x2888
+#define COMM		0x2890
+#define COLLISION	0x2900
+#define VOICES		0x2a00
+#define J1_CODE		0x2b00
+#define SCREENSHOT	0x2c00
+#define RAM_SPR		0x3000
+#define RAM_SPRPAL	0x3800
+#define RAM_SPRIMG	0x4000
+#define GD_RAM_SIZE	0x8000
+
+#define RGB(r,g,b)	((((r) >> 3) << 10) | (((g) >> 3) << 5) | ((b) >> 3))
+#define TRANSPARENT	(1 << 15)
+
+class GDClass
+{
+public:
+	static void		begin();
+	static void		end();
+	static void		__start(unsigned int Addr);
+	static void		__wstart(unsigned int Addr);
+	static void		__end();
+	static uint8_t	rd(unsigned int Addr);
+	static void		wr(unsigned int Addr,uint8_t v);
+	static unsigned int	rd16(unsigned int Addr);
+	static void		wr16(unsigned int Addr,unsigned int v);
+	static void		fill(int Addr,uint8_t v,unsigned int Count);
+	static void		copy(unsigned int Addr,const prog_uchar* Src,int Count);
+	static void		setpal(int Pal,unsigned int Rgb);
+	static void		sprite(int Spr,int x,int y,uint8_t Image,uint8_t Palette,uint8_t Rot=0,uint8_t Jk=0);
+	static void		sprite2x2(int Spr,int x,int y,uint8_t Image,uint8_t Palette,uint8_t Rot=0,uint8_t Jk=0);
+	static void		waitvblank();
+	static void		ascii();
+	static void		putstr(int x,int y,const char* String);
+	static void		voice(int v,uint8_t Wave,unsigned int Freq,uint8_t LAmp,uint8_t RAmp);
+	static void		screenshot(unsigned int Frame);
+
+	void			xsprite(int ox,int oy,signed char x,signed char y,uint8_t Image,uint8_t Palette,uint8_t Rot=0,uint8_t Jk=0);
+	void			xhide();
+	void			uncompress(unsigned int Addr,prog_uchar* Src);
+
+public:
+	uint8_t			spr;	//	next sprite for xsprite
+};
+
+extern GDClass GD;
+
+//	arduino's min/max are macros, define them last so they don't trip up system headers
+#if !defined(min)
+#define min(a,b)	((a)<(b)?(a):(b))
+#endif
+#if !defined(max)
+#define max(a,b)	((a)>(b)?(a):(b))
+#endif
+
+
+//	headless only
+namespace THeadless
+{
+	class TStats
+	{
+	public:
+		TStats() :
+			mTransactions	( 0 ),
+			mBytes			( 0 ),
+			mFrames			( 0 )
+		{
+		}
+
+	public:
+		unsigned long	mTransactions;	//	SPI transactions (chip selects)
+		unsigned long	mBytes;			//	bytes written including the 2 address bytes per transaction
+		unsigned long	mFrames;		//	waitvblank's
+	};
+
+	const uint8_t*	GetRam();			//	shadow of the gameduino's address space
+	const TStats&	GetStats();
+	void			ResetStats();
+	void			SetButtons(uint8_t PinsDown);	//	bitmask of digital pins held down
+	void			Abort(const char* Error,const char* Function);	//	asserts end up here, nobody's watching the screen
+};
@@ -0,0 +1,42 @@
+//	runs the game without the emulator window (or a gameduino), as fast as it'll go, and reports how
+//	much we wrote to the gameduino. Build from the repository root with
+//		g++ -std=c++11 -O2 -IHeadless -I. Headless/HeadlessMain.cpp Headless/GD.cpp Game.cpp Physics.cpp TGuts.cpp monkeyfight.cpp -o monkeyfight_headless
+//	usage: monkeyfight_headless [frames]
+#include "GD.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+void setup();
+void loop();
+extern uint16_t gLostCollisionTests;	//	Game.cpp
+
+int main(int argc,char* argv[])
+{
+	int FrameCount = (argc > 1) ? atoi( argv[1] ) : 600;
+
+	unsigned long SetupStartTime = micros();
+	setup();
+	unsigned long SetupDuration = micros() - SetupStartTime;
+	THeadless::TStats SetupStats = THeadless::GetStats();
+	THeadless::ResetStats();
+
+	//	collision pairs the broadphase had no room for, these are contacts that got missed
+	unsigned long LostPairs = 0;
+	int LostFrames = 0;
+	unsigned long StartTime = micros();
+	for ( int f=0;	f<FrameCount;	f++ )
+	{
+		loop();
+		LostPairs += gLostCollisionTests;
+		LostFrames += (gLostCollisionTests > 0) ? 1 : 0;
+	}
+	unsigned long Duration = micros() - StartTime;
+
+	const THeadless::TStats& Stats = THeadless::GetStats();
+	unsigned long Frames = Stats.mFrames ? Stats.mFrames : 1;
+	printf( "setup: %luus %lu transactions %lu bytes\n", SetupDuration, SetupStats.mTransactions, SetupStats.mBytes );
+	printf( "%lu frames in %luus (%luus/frame)\n", Stats.mFrames, Duration, Duration / Frames );
+	printf( "%lu transactions %lu bytes (%lu transactions %lu bytes/frame)\n", Stats.mTransactions, Stats.mBytes, Stats.mTransactions / Frames, Stats.mBytes / Frames );
+	printf( "%lu collision pairs lost over %d frames\n", LostPairs, LostFrames );
+	return 0;
+}
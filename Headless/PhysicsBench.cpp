@@ -0,0 +1,547 @@
+//	physics benchmarks. Times the collision pass (every pair through DoCollision) on a crowded pile,
+//	so float and fixed point physics can be compared, the integrate passes over 256 and 4096 bodies
+//	against the old layout where each body lived inside its player, the batched narrowphase in pairs
+//	per second (add -mavx2 for the avx2 kernel), how well the contact solver settles a pile, and the
+//	contact cache against pairing everything every frame. Build once for each from the repository root with
+//		g++ -std=c++11 -O2 -DMAX_PHYSICS_BODIES=4096 -IHeadless -I. Headless/PhysicsBench.cpp Headless/GD.cpp TGuts.cpp Physics.cpp -o physics_bench_float
+//		g++ -std=c++11 -O2 -DMAX_PHYSICS_BODIES=4096 -DMONKEYFIGHT_FIXED_PHYSICS=1 -IHeadless -I. Headless/PhysicsBench.cpp Headless/GD.cpp TGuts.cpp Physics.cpp -o physics_bench_fixed
+//	usage: physics_bench_xxx [pile bodies] [frames]
+//	the host has an fpu so this shows the cost of the maths, not the arduino's software float. On the
+//	arduino the game shows cycles per collision pair on screen
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PHYSICS_BENCH_CYCLES
+#endif
+#include "GD.h"
+#include "Physics.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAX_PILE_BODIES		64
+#define INTEGRATE_UPDATES	(8*1024*1024)	//	bodies integrated per timing, whatever the count
+
+namespace
+{
+	unsigned long long GetCycles()
+	{
+#if defined(PHYSICS_BENCH_CYCLES)
+		return __rdtsc();
+#else
+		return 0;
+#endif
+	}
+
+	//	the old layout, physics objects inside the player next to its input, sprite and glove state
+	class TPhysicsObjectAoS
+	{
+	public:
+		TCollisionShape	mCollision;
+		TPhysicsPoint	mForce;
+		TPhysicsPoint	mVelocity;
+	};
+
+	class TPlayerAoS
+	{
+	public:
+		void*				mInputSource;
+		u8					mButtons[3];
+		TPhysicsObjectAoS	mPlayerPhysics;
+		TPhysicsObjectAoS	mGlovePhysics;
+		TPhysicsPoint		mPlayerSpriteOffset;
+		u8					mSpriteState[24];	//	sprite infos and refs
+		float				mGloveAngleDeg;
+		float				mGloveDistance;
+	};
+
+	void IntegrateAoS(TPhysicsObjectAoS& Object,TPhysicsScalar Friction)
+	{
+		Object.mCollision.mPosition += Object.mVelocity;
+		Object.mVelocity *= 1.f - Friction;
+	}
+
+	void BenchCollision(int BodyCount,int FrameCount)
+	{
+		//	same radius and friction as the game, packed tight so most pairs touch
+		static TPhysicsBodies Bodies;
+		Bodies.Clear();
+		for ( int i=0;	i<BodyCount;	i++ )
+		{
+			u16 Body = Bodies.AllocBody( TPhysicsPoint( 100 + (i%6)*12, 100 + (i/6)*12 ), 8.f, (i%7)==0, 0.3f );
+			Bodies.AddForce( Body, TPhysicsPoint( (i%3)-1, (i%5)-2 ) );
+		}
+
+		printf( "%s physics, %d bodies, %d pairs per frame\n", MONKEYFIGHT_FIXED_PHYSICS ? "fixed" : "float", BodyCount, BodyCount*(BodyCount-1)/2 );
+
+		unsigned long Hits = 0;
+		unsigned long long Cycles = 0;
+		unsigned long StartTime = micros();
+		for ( int f=0;	f<FrameCount;	f++ )
+		{
+			unsigned long long StartCycles = GetCycles();
+			for ( int a=0;	a<BodyCount;	a++ )
+			{
+				for ( int b=a+1;	b<BodyCount;	b++ )
+				{
+					TCollisionTest Test( a, b );
+					DoCollision( Bodies, Test );
+					Hits += Test.mHit ? 1 : 0;
+				}
+			}
+			Cycles += GetCycles() - StartCycles;
+
+			Bodies.ApplyForces();
+			Bodies.Integrate();
+		}
+		unsigned long Duration = micros() - StartTime;
+
+		unsigned long Pairs = static_cast<unsigned long>( FrameCount ) * BodyCount*(BodyCount-1)/2;
+		printf( "%lu hits, %.3fus per collision pass", Hits, static_cast<double>( Duration ) / FrameCount );
+#if defined(PHYSICS_BENCH_CYCLES)
+		printf( ", %llu cycles per collision pass, %.1f cycles per pair", Cycles / FrameCount, static_cast<double>( Cycles ) / Pairs );
+#endif
+		printf( "\n" );
+
+		//	where things ended up, to check fixed point settles the same way as float
+		float SumX = 0.f;
+		float SumY = 0.f;
+		for ( int i=0;	i<BodyCount;	i++ )
+		{
+			SumX += TScalar::ToFloat( Bodies.mPositionX[i] );
+			SumY += TScalar::ToFloat( Bodies.mPositionY[i] );
+		}
+		printf( "centre %.2f,%.2f\n", SumX / BodyCount, SumY / BodyCount );
+	}
+
+	void PrintIntegrateResult(const char* Name,int BodyCount,unsigned long Duration,unsigned long long Cycles,float Checksum)
+	{
+		int Frames = INTEGRATE_UPDATES / BodyCount;
+		double BodiesPerSecond = static_cast<double>( Frames ) * BodyCount / (Duration / 1000000.0);
+		printf( "%-4s %4d bodies: %7.1fM bodies/s", Name, BodyCount, BodiesPerSecond / 1000000.0 );
+#if defined(PHYSICS_BENCH_CYCLES)
+		printf( " %5.2f cycles/body", static_cast<double>( Cycles ) / (static_cast<double>( Frames ) * BodyCount) );
+#endif
+		printf( " (checksum %.1f)\n", Checksum );
+	}
+
+	void BenchIntegrate(int BodyCount)
+	{
+		int Frames = INTEGRATE_UPDATES / BodyCount;
+
+		//	structure of arrays
+		static TPhysicsBodies Bodies;
+		Bodies.Clear();
+		for ( int i=0;	i<BodyCount;	i++ )
+			Bodies.AllocBody( TPhysicsPoint( i%400, i%300 ), 8.f, false, (i&1) ? 0.6f : 0.3f );
+
+		unsigned long long StartCycles = GetCycles();
+		unsigned long StartTime = micros();
+		for ( int f=0;	f<Frames;	f++ )
+		{
+			//	a push every frame so velocity doesn't settle to zero
+			Bodies.AddForce( f % BodyCount, TPhysicsPoint( 1, -1 ) );
+			Bodies.ApplyForces();
+			Bodies.Integrate();
+		}
+		unsigned long Duration = micros() - StartTime;
+		unsigned long long Cycles = GetCycles() - StartCycles;
+
+		float Checksum = 0.f;
+		for ( int i=0;	i<BodyCount;	i++ )
+			Checksum += TScalar::ToFloat( Bodies.mPositionX[i] + Bodies.mPositionY[i] );
+		PrintIntegrateResult( "SoA", BodyCount, Duration, Cycles, Checksum );
+
+		//	the old per player loop, same bodies, a player and a glove in each
+		int PlayerCount = BodyCount / 2;
+		static TPlayerAoS Players[MAX_PHYSICS_BODIES/2];
+		for ( int p=0;	p<PlayerCount;	p++ )
+		{
+			Players[p].mPlayerPhysics = TPhysicsObjectAoS();
+			Players[p].mGlovePhysics = TPhysicsObjectAoS();
+			Players[p].mPlayerPhysics.mCollision.mPosition = TPhysicsPoint( (p*2)%400, (p*2)%300 );
+			Players[p].mGlovePhysics.mCollision.mPosition = TPhysicsPoint( (p*2+1)%400, (p*2+1)%300 );
+		}
+		TPhysicsScalar PlayerFriction = 0.3f;
+		TPhysicsScalar GloveFriction = 0.6f;
+
+		StartCycles = GetCycles();
+		StartTime = micros();
+		for ( int f=0;	f<Frames;	f++ )
+		{
+			int Body = f % BodyCount;
+			TPhysicsObjectAoS& Pushed = (Body & 1) ? Players[Body/2].mGlovePhysics : Players[Body/2].mPlayerPhysics;
+			Pushed.mForce += TPhysicsPoint( 1, -1 );
+
+			for ( int p=0;	p<PlayerCount;	p++ )
+			{
+				Players[p].mPlayerPhysics.mVelocity += Players[p].mPlayerPhysics.mForce;
+				Players[p].mPlayerPhysics.mForce = TPhysicsPoint( 0, 0 );
+				Players[p].mGlovePhysics.mVelocity += Players[p].mGlovePhysics.mForce;
+				Players[p].mGlovePhysics.mForce = TPhysicsPoint( 0, 0 );
+			}
+			for ( int p=0;	p<PlayerCount;	p++ )
+			{
+				IntegrateAoS( Players[p].mPlayerPhysics, PlayerFriction );
+				IntegrateAoS( Players[p].mGlovePhysics, GloveFriction );
+			}
+		}
+		Duration = micros() - StartTime;
+		Cycles = GetCycles() - StartCycles;
+
+		Checksum = 0.f;
+		for ( int p=0;	p<PlayerCount;	p++ )
+		{
+			Checksum += TScalar::ToFloat( Players[p].mPlayerPhysics.mCollision.mPosition.x + Players[p].mPlayerPhysics.mCollision.mPosition.y );
+			Checksum += TScalar::ToFloat( Players[p].mGlovePhysics.mCollision.mPosition.x + Players[p].mGlovePhysics.mCollision.mPosition.y );
+		}
+		PrintIntegrateResult( "AoS", BodyCount, Duration, Cycles, Checksum );
+	}
+	//	candidate pairs from a broadphase that's let through everything, so most get rejected
+	void BenchNarrowphase(int BodyCount,int Repeats)
+	{
+		static TPhysicsBodies Original;
+		static TPhysicsBodies Bodies;
+		Original.Clear();
+		for ( int i=0;	i<BodyCount;	i++ )
+			Original.AllocBody( TPhysicsPoint( (i*37)%400, (i*53)%300 ), 8.f, (i%7)==0, 0.3f );
+
+		static TCollisionTest Tests[MAX_PHYSICS_BODIES*2];
+		int PairCount = 0;
+		for ( int a=0;	a<BodyCount && PairCount<NARROWPHASE_MAX_PAIRS*4;	a++ )
+		{
+			for ( int b=a+1;	b<BodyCount && PairCount<NARROWPHASE_MAX_PAIRS*4;	b++ )
+				Tests[PairCount++] = TCollisionTest( a, b );
+		}
+
+		//	a pair at a time, as Update_Collisions used to
+		unsigned long Hits = 0;
+		unsigned long long StartCycles = GetCycles();
+		unsigned long StartTime = micros();
+		for ( int r=0;	r<Repeats;	r++ )
+		{
+			Bodies = Original;
+			for ( int t=0;	t<PairCount;	t++ )
+			{
+				DoCollision( Bodies, Tests[t] );
+				Hits += Tests[t].mHit ? 1 : 0;
+			}
+		}
+		unsigned long PairTime = micros() - StartTime;
+		unsigned long long PairCycles = GetCycles() - StartCycles;
+		static TPhysicsBodies Expected;
+		Expected = Bodies;
+
+		//	batched
+		static TNarrowphase Narrowphase;
+		unsigned long BatchHits = 0;
+		StartCycles = GetCycles();
+		StartTime = micros();
+		for ( int r=0;	r<Repeats;	r++ )
+		{
+			Bodies = Original;
+			BatchHits += Narrowphase.DoCollisions( Bodies, Tests, PairCount, 2 );
+		}
+		unsigned long BatchTime = micros() - StartTime;
+		unsigned long long BatchCycles = GetCycles() - StartCycles;
+
+		bool Match = ( Hits == BatchHits );
+		for ( int i=0;	i<BodyCount;	i++ )
+			Match = Match && ( Bodies.mForceX[i] == Expected.mForceX[i] ) && ( Bodies.mForceY[i] == Expected.mForceY[i] );
+
+		//	just the rejection test
+		Narrowphase.Snapshot( Original );
+		static u16 PairA[NARROWPHASE_MAX_PAIRS*4];
+		static u16 PairB[NARROWPHASE_MAX_PAIRS*4];
+		static u16 Touching[NARROWPHASE_MAX_PAIRS*4];
+		for ( int t=0;	t<PairCount;	t++ )
+		{
+			PairA[t] = Tests[t].mBodyA;
+			PairB[t] = Tests[t].mBodyB;
+		}
+		unsigned long TouchingCount = 0;
+		StartCycles = GetCycles();
+		StartTime = micros();
+		for ( int r=0;	r<Repeats;	r++ )
+			TouchingCount += Narrowphase.FindTouchingPairs( PairA, PairB, PairCount, 2, Touching );
+		unsigned long FilterTime = micros() - StartTime;
+		unsigned long long FilterCycles = GetCycles() - StartCycles;
+
+		double Pairs = static_cast<double>( PairCount ) * Repeats;
+		printf( "%d bodies, %d candidate pairs, %lu hits, %lu touching per pass\n", BodyCount, PairCount, Hits / Repeats, TouchingCount / Repeats );
+		printf( "pair at a time: %7.1fM pairs/s %5.1f cycles/pair\n", Pairs / PairTime, PairCycles / Pairs );
+		printf( "batched (%s): %7.1fM pairs/s %5.1f cycles/pair %s\n", TNarrowphase::GetKernelName(), Pairs / BatchTime, BatchCycles / Pairs, Match ? "same contacts" : "MISMATCH" );
+		printf( "rejection only: %7.1fM pairs/s %5.1f cycles/pair\n", Pairs / FilterTime, FilterCycles / Pairs );
+	}
+	//	bodies all pushing into the middle of a pile, like a crowd of players running at each other.
+	//	Reports how much they still overlap and jiggle about once it's had time to settle
+	void BenchSolver(const char* Name,int Iterations,int Budget,TPhysicsScalar SettledDepth)
+	{
+		const int BodyCount = 40;
+		const int FrameCount = 600;
+		const int SettleFrames = 300;
+
+		static TPhysicsBodies Bodies;
+		Bodies.Clear();
+		for ( int i=0;	i<BodyCount;	i++ )
+			Bodies.AllocBody( TPhysicsPoint( 140 + (i%8)*15, 110 + (i/8)*15 ), 8.f, (i%7)==0, 0.3f );
+
+		static TCollisionTest Tests[NARROWPHASE_MAX_PAIRS];
+		static u16 HitTests[NARROWPHASE_MAX_PAIRS];
+		static TNarrowphase Narrowphase;
+		static TContactSolver Solver;
+		Solver.mIterations = Iterations;
+		Solver.mBudget = Budget;
+		Solver.mSettledDepth = SettledDepth;
+
+		double Overlap = 0;
+		double Jiggle = 0;
+		unsigned long Contacts = 0;
+		unsigned long PairTests = 0;
+		unsigned long long Cycles = 0;
+		for ( int f=0;	f<FrameCount;	f++ )
+		{
+			for ( int i=0;	i<BodyCount;	i++ )
+			{
+				TPhysicsPoint ToMiddle = TPhysicsPoint( 200, 150 ) - Bodies.GetPosition( i );
+				if ( ToMiddle.GetLengthSq() > 1 )
+				{
+					ToMiddle.Normalise( 0.3f );
+					Bodies.AddForce( i, ToMiddle );
+				}
+			}
+			Bodies.ApplyForces();
+
+			int TestCount = 0;
+			for ( int a=0;	a<BodyCount;	a++ )
+			{
+				for ( int b=a+1;	b<BodyCount;	b++ )
+					Tests[TestCount++] = TCollisionTest( a, b );
+			}
+
+			unsigned long long StartCycles = GetCycles();
+			Narrowphase.DoCollisions( Bodies, Tests, TestCount, 2 );
+			int HitCount = 0;
+			for ( int t=0;	t<TestCount;	t++ )
+			{
+				if ( Tests[t].mHit )
+					HitTests[HitCount++] = t;
+			}
+			Solver.Solve( Bodies, Tests, HitTests, HitCount );
+			unsigned long long FrameCycles = GetCycles() - StartCycles;
+
+			TPhysicsScalar OldX[BodyCount];
+			TPhysicsScalar OldY[BodyCount];
+			for ( int i=0;	i<BodyCount;	i++ )
+			{
+				OldX[i] = Bodies.mPositionX[i];
+				OldY[i] = Bodies.mPositionY[i];
+			}
+			Bodies.Integrate();
+			if ( f < SettleFrames )
+				continue;
+
+			Cycles += FrameCycles;
+			PairTests += TestCount + Solver.mTestCount;
+			for ( int i=0;	i<BodyCount;	i++ )
+				Jiggle += TScalar::ToFloat( TPhysicsPoint( Bodies.mPositionX[i] - OldX[i], Bodies.mPositionY[i] - OldY[i] ).GetLength() );
+			for ( int a=0;	a<BodyCount;	a++ )
+			{
+				for ( int b=a+1;	b<BodyCount;	b++ )
+				{
+					TPhysicsScalar Depth = Bodies.mRadius[a] + Bodies.mRadius[b] - ( Bodies.GetPosition( b ) - Bodies.GetPosition( a ) ).GetLength();
+					if ( Depth > 0 )
+					{
+						Overlap += TScalar::ToFloat( Depth );
+						Contacts++;
+					}
+				}
+			}
+		}
+
+		int Frames = FrameCount - SettleFrames;
+		printf( "%-16s %5.2f overlap per contact, %5.3f movement per body per frame, %5lu pair tests/frame, %7llu cycles/frame\n",
+			Name, Contacts ? Overlap / Contacts : 0.0, Jiggle / (Frames * BodyCount), PairTests / Frames, Cycles / Frames );
+	}
+
+	//	a crowd wandering around a small arena, every frame's contacts from every pair against the
+	//	contact cache. Checks the cache finds exactly the same contacts when it doesn't reuse any, and
+	//	how far off the pushes are when it does
+	class TCrowd
+	{
+	public:
+		void	Init(int BodyCount)
+		{
+			mBodies.Clear();
+			mSeed = 1234;
+			for ( int i=0;	i<BodyCount;	i++ )
+			{
+				mBodies.AllocBody( TPhysicsPoint( 140 + (i%8)*17, 100 + (i/8)*17 ), 8.f, (i%13)==0, 0.3f );
+				mWander[i] = 0;
+			}
+		}
+
+		void	AddForces(int Frame)
+		{
+			for ( int i=0;	i<mBodies.GetCount();	i++ )
+			{
+				//	head somewhere new every so often, and back in if they've wandered off
+				if ( (Frame + i*7) % 40 == 0 )
+				{
+					mSeed = mSeed * 1103515245 + 12345;
+					mWander[i] = (mSeed >> 16) % 8;
+				}
+				const int WanderX[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+				const int WanderY[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+				TPhysicsPoint Force( WanderX[mWander[i]], WanderY[mWander[i]] );
+				TPhysicsPoint Position = mBodies.GetPosition( i );
+				if ( Position.x < 130 || Position.x > 270 || Position.y < 90 || Position.y > 210 )
+					Force = TPhysicsPoint( 200, 150 ) - Position;
+				Force.Normalise( 0.2f );
+				mBodies.AddForce( i, Force );
+			}
+			mBodies.ApplyForces();
+		}
+
+	public:
+		TPhysicsBodies	mBodies;
+		u8				mWander[MAX_PHYSICS_BODIES];
+		u32				mSeed;
+	};
+
+	void BenchContactCache(int BodyCount,int FrameCount)
+	{
+		static TCrowd Fresh;
+		static TCrowd Exact;
+		static TCrowd Cached;
+		Fresh.Init( BodyCount );
+		Exact.Init( BodyCount );
+		Cached.Init( BodyCount );
+
+		static TCollisionTest Tests[MAX_PILE_BODIES*MAX_PILE_BODIES];
+		static TPhysicsBodies Check;
+		static TNarrowphase Narrowphase;
+		static TContactCache ExactCache;
+		static TContactCache Cache;
+		static TCollisionTest ExactTests[NARROWPHASE_MAX_PAIRS];
+		static TCollisionTest CacheTests[NARROWPHASE_MAX_PAIRS];
+		u16 ExactTestCount = 0;
+		u16 CacheTestCount = 0;
+		ExactCache.Clear();
+		ExactCache.mReuseDistance = 0;
+		Cache.Clear();
+
+		u16 CollideBodies[MAX_PHYSICS_BODIES];
+		for ( int i=0;	i<BodyCount;	i++ )
+			CollideBodies[i] = i;
+
+		bool Same = true;
+		unsigned long long FreshCycles = 0;
+		unsigned long long CacheCycles = 0;
+		unsigned long FreshTests = 0;
+		unsigned long Pairs = 0, PairChecks = 0, Moved = 0, NewPairs = 0, Hits = 0, CachedHits = 0, ReusedHits = 0;
+		double ForceError = 0;
+		double MaxForceError = 0;
+		for ( int f=0;	f<FrameCount;	f++ )
+		{
+			Fresh.AddForces( f );
+			Exact.AddForces( f );
+			Cached.AddForces( f );
+
+			//	every pair, every frame
+			unsigned long long StartCycles = GetCycles();
+			int TestCount = 0;
+			for ( int a=0;	a<BodyCount;	a++ )
+			{
+				for ( int b=a+1;	b<BodyCount;	b++ )
+					Tests[TestCount++] = TCollisionTest( a, b );
+			}
+			Narrowphase.DoCollisions( Fresh.mBodies, Tests, TestCount, 2 );
+			FreshCycles += GetCycles() - StartCycles;
+			FreshTests += TestCount;
+
+			ExactTestCount = ExactCache.Update( Exact.mBodies, ExactTests, ExactTestCount, NARROWPHASE_MAX_PAIRS, CollideBodies, BodyCount, 2 );
+			ExactCache.DoCollisions( Exact.mBodies, Narrowphase, ExactTests, ExactTestCount, 2 );
+
+			//	what every pair would push the cached crowd with
+			Check.Clear();
+			for ( int i=0;	i<BodyCount;	i++ )
+			{
+				Check.AllocBody( Cached.mBodies.GetPosition( i ), Cached.mBodies.mRadius[i], Cached.mBodies.mStatic[i], 0.3f );
+				Check.mVelocityX[i] = Cached.mBodies.mVelocityX[i];
+				Check.mVelocityY[i] = Cached.mBodies.mVelocityY[i];
+			}
+			TestCount = 0;
+			for ( int a=0;	a<BodyCount;	a++ )
+			{
+				for ( int b=a+1;	b<BodyCount;	b++ )
+					Tests[TestCount++] = TCollisionTest( a, b );
+			}
+			Narrowphase.DoCollisions( Check, Tests, TestCount, 2 );
+
+			StartCycles = GetCycles();
+			CacheTestCount = Cache.Update( Cached.mBodies, CacheTests, CacheTestCount, NARROWPHASE_MAX_PAIRS, CollideBodies, BodyCount, 2 );
+			Cache.DoCollisions( Cached.mBodies, Narrowphase, CacheTests, CacheTestCount, 2 );
+			CacheCycles += GetCycles() - StartCycles;
+
+			Pairs += CacheTestCount;
+			PairChecks += Cache.mPairChecks;
+			Moved += Cache.mMovedBodies;
+			NewPairs += Cache.mNewPairs;
+			Hits += Cache.mHitCount;
+			CachedHits += Cache.mCachedHits;
+			ReusedHits += Cache.mReusedHits;
+
+			Fresh.mBodies.Integrate();
+			Exact.mBodies.Integrate();
+			Cached.mBodies.Integrate();
+			for ( int i=0;	i<BodyCount;	i++ )
+			{
+				if ( Fresh.mBodies.mPositionX[i] != Exact.mBodies.mPositionX[i] || Fresh.mBodies.mPositionY[i] != Exact.mBodies.mPositionY[i] )
+					Same = false;
+				double Error = TScalar::ToFloat( ( Check.GetForce( i ) - Cached.mBodies.GetForce( i ) ).GetLength() );
+				ForceError += Error;
+				MaxForceError = max( MaxForceError, Error );
+			}
+		}
+
+		printf( "every pair:    %5lu pair tests/frame, %7llu cycles/frame\n", FreshTests / FrameCount, FreshCycles / FrameCount );
+		printf( "contact cache: %5lu pairs/frame, %4.1f moved bodies, %5.1f new pairs, %5lu pairing checks, %7llu cycles/frame\n",
+			Pairs / FrameCount, static_cast<double>( Moved ) / FrameCount, static_cast<double>( NewPairs ) / FrameCount, PairChecks / FrameCount, CacheCycles / FrameCount );
+		printf( "               %5.1f contacts/frame, %3d%% cached, %3d%% warm, %s without reuse\n               %.5f push error per body with it, %.3f at most\n",
+			static_cast<double>( Hits ) / FrameCount, Hits ? static_cast<int>( CachedHits*100 / Hits ) : 0, Hits ? static_cast<int>( ReusedHits*100 / Hits ) : 0,
+			Same ? "same contacts as every pair" : "DIFFERENT contacts to every pair", ForceError / (FrameCount * BodyCount), MaxForceError );
+	}
+}
+
+int main(int argc,char* argv[])
+{
+#if defined(PHYSICS_BENCH_CYCLES)
+	//	velocities left to friction go denormal after a few hundred frames and swamp the timings
+	_mm_setcsr( _mm_getcsr() | 0x8040 );	//	flush to zero, denormals are zero
+#endif
+
+	int BodyCount = (argc > 1) ? atoi( argv[1] ) : 24;
+	int FrameCount = (argc > 2) ? atoi( argv[2] ) : 1000;
+	BodyCount = min( BodyCount, MAX_PILE_BODIES );
+
+	BenchCollision( BodyCount, FrameCount );
+
+	printf( "integrate (force -> velocity -> position -> friction)\n" );
+	BenchIntegrate( 256 );
+	if ( MAX_PHYSICS_BODIES >= 4096 )
+		BenchIntegrate( 4096 );
+	else
+		printf( "build with -DMAX_PHYSICS_BODIES=4096 for the 4096 body run\n" );
+
+	printf( "narrowphase\n" );
+	BenchNarrowphase( 256, 200 );
+
+	printf( "contact solver, 40 bodies pushing into a pile\n" );
+	BenchSolver( "first pass only", 0, 0, CONTACT_SOLVER_SETTLED );
+	BenchSolver( "every contact x4", 4, 0xffff, 0 );
+	BenchSolver( "islands", CONTACT_SOLVER_ITERATIONS, CONTACT_SOLVER_BUDGET, CONTACT_SOLVER_SETTLED );
+
+	printf( "contact cache, 64 bodies wandering around for %d frames\n", FrameCount );
+	BenchContactCache( 64, FrameCount );
+
+	return 0;
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include <stdint.h>
+
+//	headless stand-in for the arduino SPI library. Gameduino writes go __wstart() -> transfer()... -> __end()
+//	so transfer() writes into the shadow ram at the current GD address
+class SPIClass
+{
+public:
+	static uint8_t	transfer(uint8_t Data);
+};
+
+extern SPIClass SPI;
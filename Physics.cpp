@@ -0,0 +1,690 @@
+//	intrinsics before anything that brings in arduino's min/max macros
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+#include "Physics.h"
+
+//	widest narrowphase kernel the compiler lets us use. Fixed point stays scalar, squaring it needs
+//	32 bit multiplies that SSE2 doesn't have
+#if !MONKEYFIGHT_FIXED_PHYSICS && defined(__AVX2__)
+#define NARROWPHASE_AVX2
+#elif !MONKEYFIGHT_FIXED_PHYSICS && (defined(__SSE2__) || defined(_M_X64))
+#define NARROWPHASE_SSE
+#endif
+
+
+u16 TPhysicsBodies::AllocBody(const TPhysicsPoint& Position,TPhysicsScalar Radius,bool Static,TPhysicsScalar Friction)
+{
+	assert( mCount < MAX_PHYSICS_BODIES, "Out of physics bodies" );
+	u16 Body = mCount++;
+
+	//	starting a new batch, zero the spares in it so integrating them does nothing
+	if ( (Body % PHYSICS_BODY_BATCH) == 0 )
+	{
+		for ( u16 i=Body+1;	i<Body+PHYSICS_BODY_BATCH;	i++ )
+			ResetBody( i );
+	}
+
+	ResetBody( Body );
+	mPositionX[Body] = Position.x;
+	mPositionY[Body] = Position.y;
+	mRadius[Body] = Radius;
+	mDamping[Body] = 1.f - Friction;
+	mStatic[Body] = Static;
+	return Body;
+}
+
+void TPhysicsBodies::ResetBody(u16 Body)
+{
+	mPositionX[Body] = 0;
+	mPositionY[Body] = 0;
+	mVelocityX[Body] = 0;
+	mVelocityY[Body] = 0;
+	mForceX[Body] = 0;
+	mForceY[Body] = 0;
+	mRadius[Body] = 0;
+	mDamping[Body] = 0;
+	mStatic[Body] = true;
+}
+
+TCollisionShape TPhysicsBodies::GetWorldCollisionShape(u16 Body) const
+{
+	TPhysicsPoint Position( mPositionX[Body] + mVelocityX[Body] + mForceX[Body], mPositionY[Body] + mVelocityY[Body] + mForceY[Body] );
+	return TCollisionShape( Position, mRadius[Body], mStatic[Body] );
+}
+
+void TPhysicsBodies::ApplyForces()
+{
+	//	whole batches, the spare bodies on the end are left zeroed so it doesn't matter that they're updated
+	u16 Count = GetBatchedCount();
+	for ( u16 i=0;	i<Count;	i++ )
+	{
+		mVelocityX[i] += mForceX[i];
+		mVelocityY[i] += mForceY[i];
+		mForceX[i] = 0;
+		mForceY[i] = 0;
+	}
+}
+
+void TPhysicsBodies::Integrate()
+{
+	u16 Count = GetBatchedCount();
+
+	//	move with velocity
+	for ( u16 i=0;	i<Count;	i++ )
+	{
+		mPositionX[i] += mVelocityX[i];
+		mPositionY[i] += mVelocityY[i];
+	}
+
+	//	dampen velocity
+	for ( u16 i=0;	i<Count;	i++ )
+	{
+		mVelocityX[i] *= mDamping[i];
+		mVelocityY[i] *= mDamping[i];
+	}
+}
+
+
+void TNarrowphase::Snapshot(const TPhysicsBodies& Bodies)
+{
+	//	same as TPhysicsBodies::GetWorldCollisionShape
+	mCount = Bodies.GetCount();
+	for ( u16 i=0;	i<mCount;	i++ )
+	{
+		mWorldX[i] = Bodies.mPositionX[i] + Bodies.mVelocityX[i] + Bodies.mForceX[i];
+		mWorldY[i] = Bodies.mPositionY[i] + Bodies.mVelocityY[i] + Bodies.mForceY[i];
+		mRadius[i] = Bodies.mRadius[i];
+	}
+}
+
+const char* TNarrowphase::GetKernelName()
+{
+#if defined(NARROWPHASE_AVX2)
+	return "avx2";
+#elif defined(NARROWPHASE_SSE)
+	return "sse";
+#else
+	return "scalar";
+#endif
+}
+
+u16 TNarrowphase::FindTouchingPairs(const u16* BodyA,const u16* BodyB,u16 PairCount,TPhysicsScalar Margin,u16* Touching) const
+{
+	u16 TouchingCount = 0;
+	u16 p = 0;
+
+#if defined(NARROWPHASE_AVX2)
+	__m256 Margin8 = _mm256_set1_ps( Margin );
+	for ( ;	p+8<=PairCount;	p+=8 )
+	{
+		__m256i a = _mm256_cvtepu16_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>( &BodyA[p] ) ) );
+		__m256i b = _mm256_cvtepu16_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>( &BodyB[p] ) ) );
+		__m256 dx = _mm256_sub_ps( _mm256_i32gather_ps( mWorldX, b, 4 ), _mm256_i32gather_ps( mWorldX, a, 4 ) );
+		__m256 dy = _mm256_sub_ps( _mm256_i32gather_ps( mWorldY, b, 4 ), _mm256_i32gather_ps( mWorldY, a, 4 ) );
+		__m256 r = _mm256_add_ps( _mm256_add_ps( _mm256_i32gather_ps( mRadius, a, 4 ), _mm256_i32gather_ps( mRadius, b, 4 ) ), Margin8 );
+		__m256 DistanceSq = _mm256_add_ps( _mm256_mul_ps( dx, dx ), _mm256_mul_ps( dy, dy ) );
+		int Mask = _mm256_movemask_ps( _mm256_cmp_ps( DistanceSq, _mm256_mul_ps( r, r ), _CMP_LE_OQ ) );
+		for ( int i=0;	Mask;	i++,Mask>>=1 )
+		{
+			if ( Mask & 1 )
+				Touching[TouchingCount++] = p + i;
+		}
+	}
+#elif defined(NARROWPHASE_SSE)
+	__m128 Margin4 = _mm_set1_ps( Margin );
+	for ( ;	p+4<=PairCount;	p+=4 )
+	{
+		const u16* a = &BodyA[p];
+		const u16* b = &BodyB[p];
+		__m128 dx = _mm_sub_ps( _mm_set_ps( mWorldX[b[3]], mWorldX[b[2]], mWorldX[b[1]], mWorldX[b[0]] ), _mm_set_ps( mWorldX[a[3]], mWorldX[a[2]], mWorldX[a[1]], mWorldX[a[0]] ) );
+		__m128 dy = _mm_sub_ps( _mm_set_ps( mWorldY[b[3]], mWorldY[b[2]], mWorldY[b[1]], mWorldY[b[0]] ), _mm_set_ps( mWorldY[a[3]], mWorldY[a[2]], mWorldY[a[1]], mWorldY[a[0]] ) );
+		__m128 r = _mm_add_ps( _mm_add_ps( _mm_set_ps( mRadius[a[3]], mRadius[a[2]], mRadius[a[1]], mRadius[a[0]] ), _mm_set_ps( mRadius[b[3]], mRadius[b[2]], mRadius[b[1]], mRadius[b[0]] ) ), Margin4 );
+		__m128 DistanceSq = _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_mul_ps( dy, dy ) );
+		int Mask = _mm_movemask_ps( _mm_cmple_ps( DistanceSq, _mm_mul_ps( r, r ) ) );
+		for ( int i=0;	Mask;	i++,Mask>>=1 )
+		{
+			if ( Mask & 1 )
+				Touching[TouchingCount++] = p + i;
+		}
+	}
+#endif
+
+	//	scalar, for the arduino and whatever's left over
+	for ( ;	p<PairCount;	p++ )
+	{
+		u16 a = BodyA[p];
+		u16 b = BodyB[p];
+		TPhysicsScalar dx = mWorldX[b] - mWorldX[a];
+		TPhysicsScalar dy = mWorldY[b] - mWorldY[a];
+		TPhysicsScalar r = mRadius[a] + mRadius[b] + Margin;
+		if ( dx > r || dx < -r || dy > r || dy < -r )
+			continue;
+		if ( (dx*dx) + (dy*dy) <= r*r )
+			Touching[TouchingCount++] = p;
+	}
+	return TouchingCount;
+}
+
+u16 TNarrowphase::DoCollisions(TPhysicsBodies& Bodies,TCollisionTest* Tests,u16 TestCount,TPhysicsScalar Margin)
+{
+	Snapshot( Bodies );
+
+	u16 HitCount = 0;
+	for ( u16 First=0;	First<TestCount;	First+=NARROWPHASE_MAX_PAIRS )
+	{
+		u16 Count = min( TestCount-First, NARROWPHASE_MAX_PAIRS );
+		for ( u16 i=0;	i<Count;	i++ )
+		{
+			TCollisionTest& Test = Tests[First+i];
+			Test.mHit = false;
+
+			//	invalid tests test body 0 against itself, DoCollision throws them out
+			mPairA[i] = Test.IsValid() ? Test.mBodyA : 0;
+			mPairB[i] = Test.IsValid() ? Test.mBodyB : 0;
+		}
+
+		//	full contact for the ones that might touch, in the order they came in
+		u16 TouchingCount = FindTouchingPairs( mPairA, mPairB, Count, Margin, mTouching );
+		for ( u16 t=0;	t<TouchingCount;	t++ )
+		{
+			TCollisionTest& Test = Tests[First+mTouching[t]];
+			DoCollision( Bodies, Test );
+			HitCount += Test.mHit ? 1 : 0;
+		}
+	}
+	return HitCount;
+}
+
+
+TPhysicsScalar TContactSolver::GetDepth(const TPhysicsBodies& Bodies,const TCollisionTest& Test) const
+{
+	return Bodies.mRadius[Test.mBodyA] + Bodies.mRadius[Test.mBodyB] - Test.mIntersectionA.mDistance;
+}
+
+u16 TContactSolver::FindIsland(u16 Body)
+{
+	//	halve the path as we go so the trees stay flat
+	while ( mIslandParent[Body] != Body )
+	{
+		mIslandParent[Body] = mIslandParent[ mIslandParent[Body] ];
+		Body = mIslandParent[Body];
+	}
+	return Body;
+}
+
+void TContactSolver::BuildIslands(const TPhysicsBodies& Bodies,const TCollisionTest* Tests,const u16* HitTests,u16 HitCount)
+{
+	//	only the bodies in contact need resetting
+	for ( u16 h=0;	h<HitCount;	h++ )
+	{
+		const TCollisionTest& Test = Tests[HitTests[h]];
+		mIslandParent[Test.mBodyA] = Test.mBodyA;
+		mIslandParent[Test.mBodyB] = Test.mBodyB;
+	}
+
+	//	join the two bodies of every contact, lowest body is the root
+	for ( u16 h=0;	h<HitCount;	h++ )
+	{
+		const TCollisionTest& Test = Tests[HitTests[h]];
+		u16 RootA = FindIsland( Test.mBodyA );
+		u16 RootB = FindIsland( Test.mBodyB );
+		if ( RootA < RootB )
+			mIslandParent[RootB] = RootA;
+		else if ( RootB < RootA )
+			mIslandParent[RootA] = RootB;
+	}
+
+	//	number the islands and count their contacts
+	for ( u16 h=0;	h<HitCount;	h++ )
+		mRootIsland[ FindIsland( Tests[HitTests[h]].mBodyA ) ] = 0xffff;
+
+	mIslandCount = 0;
+	mHitIsland.SetSize( HitCount );
+	mIslandFirst.SetSize( 1 );
+	mIslandFirst[0] = 0;
+	for ( u16 h=0;	h<HitCount;	h++ )
+	{
+		u16& Island = mRootIsland[ FindIsland( Tests[HitTests[h]].mBodyA ) ];
+		if ( Island == 0xffff )
+		{
+			Island = mIslandCount++;
+			mIslandFirst.PushBack( 0 );
+		}
+		mHitIsland[h] = Island;
+		mIslandFirst[Island+1]++;
+	}
+
+	//	counting sort the contacts into islands, keeping their order within each
+	for ( u16 i=0;	i<mIslandCount;	i++ )
+		mIslandFirst[i+1] += mIslandFirst[i];
+
+	mIslandTests.SetSize( HitCount );
+	for ( u16 h=0;	h<HitCount;	h++ )
+		mIslandTests[ mIslandFirst[mHitIsland[h]]++ ] = HitTests[h];
+
+	for ( u16 i=mIslandCount;	i>0;	i-- )
+		mIslandFirst[i] = mIslandFirst[i-1];
+	mIslandFirst[0] = 0;
+
+	//	islands that came out of the first pass barely touching are already settled
+	mActiveIslands.Clear();
+	for ( u16 i=0;	i<mIslandCount;	i++ )
+	{
+		for ( u16 t=mIslandFirst[i];	t<mIslandFirst[i+1];	t++ )
+		{
+			if ( GetDepth( Bodies, Tests[mIslandTests[t]] ) >= mSettledDepth )
+			{
+				mActiveIslands.PushBack( i );
+				break;
+			}
+		}
+	}
+}
+
+void TContactSolver::Solve(TPhysicsBodies& Bodies,TCollisionTest* Tests,const u16* HitTests,u16 HitCount)
+{
+	mIslandCount = 0;
+	mIterationCount = 0;
+	mTestCount = 0;
+	HitCount = min( HitCount, mIslandTests.MaxSize() );
+	if ( HitCount == 0 || mIterations == 0 )
+		return;
+
+	BuildIslands( Bodies, Tests, HitTests, HitCount );
+
+	while ( !mActiveIslands.IsEmpty() && mIterationCount < mIterations && mTestCount < mBudget )
+	{
+		mIterationCount++;
+
+		//	islands don't share bodies so the order doesn't matter, backwards so settled ones can be swapped out
+		for ( int a=mActiveIslands.GetTailIndex();	a>=0 && mTestCount<mBudget;	a-- )
+		{
+			u16 Island = mActiveIslands[a];
+			TPhysicsScalar Deepest = 0;
+			for ( u16 t=mIslandFirst[Island];	t<mIslandFirst[Island+1] && mTestCount<mBudget;	t++ )
+			{
+				TCollisionTest& Test = Tests[mIslandTests[t]];
+				DoCollision( Bodies, Test );
+				mTestCount++;
+				if ( Test.mHit )
+					Deepest = max( Deepest, GetDepth( Bodies, Test ) );
+			}
+
+			//	pushed apart enough, stop testing it
+			if ( Deepest < mSettledDepth )
+			{
+				mActiveIslands[a] = mActiveIslands[mActiveIslands.GetTailIndex()];
+				mActiveIslands.SetSize( mActiveIslands.GetSize()-1 );
+			}
+		}
+	}
+}
+
+
+TContactCache::TContactCache() :
+	mSkin			( CONTACT_CACHE_SKIN ),
+	mReuseDistance	( CONTACT_CACHE_REUSE ),
+	mMovedBodies	( 0 ),
+	mNewPairs		( 0 ),
+	mLostPairs		( 0 ),
+	mDeferredPairs	( 0 ),
+	mPairChecks		( 0 ),
+	mHitCount		( 0 ),
+	mCachedHits		( 0 ),
+	mReusedHits		( 0 )
+{
+	Clear();
+}
+
+void TContactCache::Clear()
+{
+	for ( u16 i=0;	i<MAX_PHYSICS_BODIES;	i++ )
+	{
+		mPaired[i] = false;
+		mMoved[i] = false;
+		mColliding[i] = false;
+	}
+}
+
+u16 TContactCache::Update(const TPhysicsBodies& Bodies,TCollisionTest* Tests,u16 TestCount,u16 MaxTests,const u16* CollideBodies,u16 CollideCount,TPhysicsScalar Margin)
+{
+	u16 BodyCount = Bodies.GetCount();
+	for ( u16 i=0;	i<BodyCount;	i++ )
+	{
+		mMoved[i] = false;
+		mColliding[i] = false;
+	}
+
+	//	pair up again anything that's new or has moved half the skin since it was last paired. Anything
+	//	that hasn't is still within half the skin of where it was paired, so two of them can't have got
+	//	close enough to touch without already being within the skin of each other
+	TPhysicsScalar HalfSkin = mSkin * TPhysicsScalar( 0.5f );
+	mMovedBodies = 0;
+	for ( u16 c=0;	c<CollideCount;	c++ )
+	{
+		u16 Body = CollideBodies[c];
+		mColliding[Body] = true;
+
+		TCollisionShape Shape = Bodies.GetWorldCollisionShape( Body );
+		TPhysicsPoint Moved = Shape.mPosition - TPhysicsPoint( mPairedX[Body], mPairedY[Body] );
+		if ( mPaired[Body] && Moved.x < HalfSkin && Moved.x > -HalfSkin && Moved.y < HalfSkin && Moved.y > -HalfSkin && Moved.GetLengthSq() < HalfSkin*HalfSkin )
+			continue;
+
+		mPairedX[Body] = Shape.mPosition.x;
+		mPairedY[Body] = Shape.mPosition.y;
+		mPaired[Body] = true;
+		mMoved[Body] = true;
+		mMovedBodies++;
+	}
+	for ( u16 i=0;	i<BodyCount;	i++ )
+	{
+		if ( !mColliding[i] )
+			mPaired[i] = false;
+	}
+
+	//	drop the pairs of anything that's moved or isn't colliding any more, the rest stay in order
+	u16 Kept = 0;
+	for ( u16 t=0;	t<TestCount;	t++ )
+	{
+		const TCollisionTest& Test = Tests[t];
+		if ( Test.mBodyA >= BodyCount || Test.mBodyB >= BodyCount )
+			continue;
+		if ( mMoved[Test.mBodyA] || mMoved[Test.mBodyB] || !mColliding[Test.mBodyA] || !mColliding[Test.mBodyB] )
+			continue;
+		Tests[Kept++] = Test;
+	}
+
+	//	pair the moved bodies with everything near where it was last paired
+	mNewKeys.Clear();
+	mPairChecks = 0;
+	mLostPairs = 0;
+	mDeferredPairs = 0;
+	u16 MaxNewPairs = min( MaxTests - Kept, mNewKeys.MaxSize() );
+	for ( u16 c=0;	c<CollideCount;	c++ )
+	{
+		u16 Body = CollideBodies[c];
+		if ( mMoved[Body] )
+			AddPairs( Bodies, Body, CollideBodies, CollideCount, Margin, MaxNewPairs, true, true );
+	}
+
+	//	out of room (everything's new on the first frame), pair again with the pairs that are touching
+	//	now first, so it's pairs that are only in the skin that miss out. Their bodies are paired again
+	//	next frame, and nothing's lost unless there isn't room for the touching pairs either
+	if ( mLostPairs > 0 )
+	{
+		mNewKeys.Clear();
+		mLostPairs = 0;
+		for ( u16 c=0;	c<CollideCount;	c++ )
+		{
+			u16 Body = CollideBodies[c];
+			if ( mMoved[Body] )
+			{
+				mPaired[Body] = true;
+				AddPairs( Bodies, Body, CollideBodies, CollideCount, Margin, MaxNewPairs, true, false );
+			}
+		}
+		for ( u16 c=0;	c<CollideCount;	c++ )
+		{
+			u16 Body = CollideBodies[c];
+			if ( mMoved[Body] )
+				AddPairs( Bodies, Body, CollideBodies, CollideCount, Margin, MaxNewPairs, false, true );
+		}
+	}
+	mNewPairs = mNewKeys.GetSize();
+
+	//	insertion sort, the moved bodies come in order so the new pairs are nearly sorted already
+	for ( u16 n=1;	n<mNewKeys.GetSize();	n++ )
+	{
+		u32 Key = mNewKeys[n];
+		u16 i = n;
+		for ( ;	i>0 && mNewKeys[i-1] > Key;	i-- )
+			mNewKeys[i] = mNewKeys[i-1];
+		mNewKeys[i] = Key;
+	}
+
+	//	merge into the kept pairs from the back
+	TestCount = Kept + mNewKeys.GetSize();
+	int Old = Kept - 1;
+	int New = mNewKeys.GetSize() - 1;
+	for ( int Write=TestCount-1;	New>=0;	Write-- )
+	{
+		if ( Old >= 0 && ( (static_cast<u32>( Tests[Old].mBodyA ) << 16) | Tests[Old].mBodyB ) > mNewKeys[New] )
+		{
+			Tests[Write] = Tests[Old--];
+		}
+		else
+		{
+			Tests[Write] = TCollisionTest( mNewKeys[New] >> 16, mNewKeys[New] & 0xffff );
+			New--;
+		}
+	}
+	return TestCount;
+}
+
+void TContactCache::AddPairs(const TPhysicsBodies& Bodies,u16 Body,const u16* CollideBodies,u16 CollideCount,TPhysicsScalar Margin,u16 MaxNewPairs,bool AddTouching,bool AddSkin)
+{
+	for ( u16 c=0;	c<CollideCount;	c++ )
+	{
+		u16 Other = CollideBodies[c];
+
+		//	pairs of two moved bodies are added by the lower one
+		if ( Other == Body || ( mMoved[Other] && Other < Body ) )
+			continue;
+
+		//	against where the other body was paired, not where it is now, so the skin still covers it
+		mPairChecks++;
+		TPhysicsScalar Reach = Bodies.mRadius[Body] + Bodies.mRadius[Other] + Margin + mSkin;
+		TPhysicsScalar dx = mPairedX[Other] - mPairedX[Body];
+		TPhysicsScalar dy = mPairedY[Other] - mPairedY[Body];
+		if ( dx > Reach || dx < -Reach || dy > Reach || dy < -Reach )
+			continue;
+		if ( (dx*dx) + (dy*dy) > Reach*Reach )
+			continue;
+
+		//	only one kind of pair this pass, touching is the same test the narrowphase rejects pairs with.
+		//	The moved body was just paired, so its paired position is where it is now
+		if ( !AddTouching || !AddSkin )
+		{
+			TPhysicsScalar TouchReach = Bodies.mRadius[Body] + Bodies.mRadius[Other] + Margin;
+			TPhysicsPoint OtherPosition = Bodies.GetWorldCollisionShape( Other ).mPosition;
+			TPhysicsScalar tx = OtherPosition.x - mPairedX[Body];
+			TPhysicsScalar ty = OtherPosition.y - mPairedY[Body];
+			bool Touching = tx <= TouchReach && tx >= -TouchReach && ty <= TouchReach && ty >= -TouchReach && (tx*tx) + (ty*ty) <= TouchReach*TouchReach;
+			if ( Touching != AddTouching )
+				continue;
+		}
+
+		//	out of room, this pair isn't tested this frame. Pair the body again next frame so it's
+		//	picked up once there's space. A pair that's only in the skin can wait, a touching one is lost
+		if ( mNewKeys.GetSize() >= MaxNewPairs )
+		{
+			mPaired[Body] = false;
+			if ( AddTouching )
+				mLostPairs++;
+			else
+				mDeferredPairs++;
+			continue;
+		}
+
+		u16 BodyA = min( Body, Other );
+		u16 BodyB = max( Body, Other );
+		mNewKeys.PushBack( (static_cast<u32>( BodyA ) << 16) | BodyB );
+	}
+}
+
+u16 TContactCache::DoCollisions(TPhysicsBodies& Bodies,TNarrowphase& Narrowphase,TCollisionTest* Tests,u16 TestCount,TPhysicsScalar Margin)
+{
+	mHitCount = 0;
+	mCachedHits = 0;
+	mReusedHits = 0;
+
+	Narrowphase.Snapshot( Bodies );
+
+	for ( u16 First=0;	First<TestCount;	First+=NARROWPHASE_MAX_PAIRS )
+	{
+		//	batch reject the pairs that are too far apart, same as a fresh list of pairs would be
+		u16 Count = min( TestCount-First, NARROWPHASE_MAX_PAIRS );
+		for ( u16 i=0;	i<Count;	i++ )
+		{
+			Narrowphase.mPairA[i] = Tests[First+i].mBodyA;
+			Narrowphase.mPairB[i] = Tests[First+i].mBodyB;
+		}
+		u16 TouchingCount = Narrowphase.FindTouchingPairs( Narrowphase.mPairA, Narrowphase.mPairB, Count, Margin, Narrowphase.mTouching );
+
+		//	then contacts in pair order
+		u16 Touching = 0;
+		for ( u16 i=0;	i<Count;	i++ )
+		{
+			TCollisionTest& Test = Tests[First+i];
+			if ( Touching >= TouchingCount || Narrowphase.mTouching[Touching] != i )
+			{
+				Test.mHit = false;
+				continue;
+			}
+			Touching++;
+
+			//	touching deeper than it could have moved last frame, and barely moved, push them apart the
+			//	same way again
+			bool Reuse = false;
+			TPhysicsScalar Depth = Bodies.mRadius[Test.mBodyA] + Bodies.mRadius[Test.mBodyB] - Test.mIntersectionA.mDistance;
+			if ( Test.mHit && Depth > mReuseDistance )
+			{
+				TPhysicsPoint Diff = Bodies.GetWorldCollisionShape( Test.mBodyB ).mPosition - Bodies.GetWorldCollisionShape( Test.mBodyA ).mPosition;
+				Diff -= Test.mDiff;
+				Reuse = Diff.x < mReuseDistance && Diff.x > -mReuseDistance && Diff.y < mReuseDistance && Diff.y > -mReuseDistance && Diff.GetLengthSq() < mReuseDistance*mReuseDistance;
+			}
+
+			if ( Reuse )
+			{
+				OnCollision( Bodies, Test.mBodyA, Test.mIntersectionA );
+				OnCollision( Bodies, Test.mBodyB, Test.mIntersectionB );
+				mReusedHits++;
+			}
+			else
+			{
+				DoCollision( Bodies, Test );
+			}
+
+			if ( !Test.mHit )
+				continue;
+			mHitCount++;
+			if ( !mMoved[Test.mBodyA] && !mMoved[Test.mBodyB] )
+				mCachedHits++;
+		}
+	}
+	return mHitCount;
+}
+
+
+bool GetIntersection(TCollisionShape& a,TCollisionShape& b,TIntersection& NodeAIntersection,TIntersection& NodeBIntersection)
+{
+	//	get the vector between the spheres
+	TPhysicsPoint Diff( b.mPosition - a.mPosition );
+	//float2 Diff = NodeAIntersection.mDistance;
+
+	//	too far away on either axis, before squaring so fixed point doesn't overflow
+	TPhysicsScalar TotalRad = a.mRadius + b.mRadius;
+	if ( Diff.x > TotalRad || Diff.x < -TotalRad || Diff.y > TotalRad || Diff.y < -TotalRad )
+		return false;
+
+	//	too embedded to do anything with it 
+	TPhysicsScalar DiffLengthSq = Diff.GetLengthSq();
+	if ( DiffLengthSq < TLMaths::g_NearZero )     
+		return false;   
+
+	TPhysicsScalar TotalRadSq = TotalRad * TotalRad;
+
+	//	too far away to intersect
+	if ( DiffLengthSq > TotalRadSq )
+		return false;
+
+	//	save distance
+	//	gr: should this be a vector?
+	NodeAIntersection.mDistance = sqrt(DiffLengthSq);
+
+	//	calc impact weighting
+	if ( a.mStatic != b.mStatic )
+	{
+		NodeAIntersection.mForceWeight = a.mStatic ? 1 : 0;
+	}
+	else
+	{
+		//	work out relative weights of object
+		TPhysicsScalar ObjectAWeight = 0.5f;
+
+		//	get force relativity (both weighting and then dotproduct relevance)
+		
+		//	force weight
+		NodeAIntersection.mForceWeight = ObjectAWeight;
+	}
+
+
+	//	intersected, work out the intersection points
+	NodeAIntersection.mIntersection = Diff;
+	NodeAIntersection.mIntersection.Normalise( a.mRadius );
+	NodeAIntersection.mIntersection += a.mPosition;
+	
+	NodeAIntersection.mOtherIntersection = Diff;
+	NodeAIntersection.mOtherIntersection.Normalise( b.mRadius );
+	NodeAIntersection.mOtherIntersection += b.mPosition;	
+	
+	NodeAIntersection.mMidPoint = Diff;
+	NodeAIntersection.mMidPoint *= TPhysicsScalar( 0.5f );
+	NodeAIntersection.mMidPoint += a.mPosition;
+
+	//	copy to intersection B
+	NodeBIntersection.mDistance = -NodeAIntersection.mDistance;
+	NodeBIntersection.mMidPoint = NodeAIntersection.mMidPoint;
+	NodeBIntersection.mIntersection = NodeAIntersection.mOtherIntersection;
+	NodeBIntersection.mOtherIntersection = NodeAIntersection.mIntersection;
+	NodeBIntersection.mForceWeight = 1.f - NodeAIntersection.mForceWeight;
+
+	return true;
+}
+
+void OnCollision(TPhysicsBodies& Bodies,u16 Body,const TIntersection& Intersection)
+{
+	//	we want to move our intersection point up to the edge of where the other object intersected
+	TPhysicsPoint Delta = Intersection.mOtherIntersection - Intersection.mIntersection;
+
+	//	if the force weight is 1 then we don't move as all the power is on OUR side.
+	//	if it's zero, we take ALL the impact
+	Delta *= 1.f - Intersection.mForceWeight;
+
+	//	gr: should not be neccessary...
+	TPhysicsScalar Bounce = 10.f;
+	Delta*=1.f/Bounce;//0.5f;
+
+	//	change the movement delta if we're against a static object (so definately is moved)
+	//	if it's a soft object (not static) then change the velocity
+	//	gr: had to NEGATE this from tootle code... WHY???
+	Bodies.mForceX[Body] -= Delta.x;
+	Bodies.mForceY[Body] -= Delta.y;
+}
+
+
+void DoCollision(TPhysicsBodies& Bodies,TCollisionTest& CollisionTest)
+{
+	CollisionTest.mHit = false;
+	if ( !CollisionTest.IsValid() )
+		return;
+	u16 ObjA = CollisionTest.mBodyA;
+	u16 ObjB = CollisionTest.mBodyB;
+
+	TCollisionShape ColShapeA = Bodies.GetWorldCollisionShape( ObjA );
+	TCollisionShape ColShapeB = Bodies.GetWorldCollisionShape( ObjB );
+	if ( !ColShapeA.IsValid() || !ColShapeB.IsValid() )
+		return;
+
+	if ( !GetIntersection( ColShapeA, ColShapeB, CollisionTest.mIntersectionA, CollisionTest.mIntersectionB ) )
+		return;
+	CollisionTest.mDiff = ColShapeB.mPosition - ColShapeA.mPosition;
+
+	CollisionTest.mHit = true;
+
+	OnCollision( Bodies, ObjA, CollisionTest.mIntersectionA );
+	OnCollision( Bodies, ObjB, CollisionTest.mIntersectionB );
+}
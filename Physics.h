@@ -0,0 +1,273 @@
+#pragma once
+#include "TGuts.h"
+
+//	do the physics and collision maths in fixed point rather than float. The arduino has no FPU
+//	so every float op is a software routine; fixed point is just integer ops
+#if !defined(MONKEYFIGHT_FIXED_PHYSICS)
+#define MONKEYFIGHT_FIXED_PHYSICS	0
+#endif
+
+#if MONKEYFIGHT_FIXED_PHYSICS
+typedef TFixed			TPhysicsScalar;
+#else
+typedef float			TPhysicsScalar;
+#endif
+typedef Type2<TPhysicsScalar,TVector2Trig<TPhysicsScalar>>	TPhysicsPoint;
+
+
+namespace TLMaths
+{
+#if MONKEYFIGHT_FIXED_PHYSICS
+	const TPhysicsScalar	g_NearZero = TFixed::FromRaw( 1 );	//	smallest step fixed point can hold
+#else
+	const TPhysicsScalar	g_NearZero = 0.0001f;
+#endif
+};
+
+class TCollisionShape
+{
+public:
+	TCollisionShape() :
+		mRadius		( -1.f ),
+		mStatic		( false )
+	{
+	}
+	TCollisionShape(const TPhysicsPoint& Position,TPhysicsScalar Radius,bool Static) :
+		mPosition	( Position ),
+		mRadius		( Radius ),
+		mStatic		( Static )
+	{
+	}
+
+	bool			IsValid() const		{	return mRadius > 0.f;	}
+
+public:
+	TPhysicsPoint	mPosition;	//	offset from parent's pos
+	TPhysicsScalar	mRadius;
+	bool			mStatic;	//	if static, object will not move
+};
+
+//	bodies allowed in a TPhysicsBodies (a player and a glove each for 256 players)
+#if !defined(MAX_PHYSICS_BODIES)
+#define MAX_PHYSICS_BODIES	512
+#endif
+
+//	the integrate passes run over whole batches of bodies so the compiler knows there's no odd
+//	bodies left over, which is what gets them vectorised at -O2
+#define PHYSICS_BODY_BATCH	4
+
+#if (MAX_PHYSICS_BODIES % PHYSICS_BODY_BATCH) != 0
+#error MAX_PHYSICS_BODIES must be a multiple of PHYSICS_BODY_BATCH
+#endif
+
+//	physics state for every body, one array per field so the integrate passes walk through memory
+//	in order (and vectorise on the host). Plain arrays rather than BufferArray so there's no
+//	bounds check in the loops
+class TPhysicsBodies
+{
+public:
+	TPhysicsBodies() :
+		mCount	( 0 )
+	{
+	}
+
+	u16				AllocBody(const TPhysicsPoint& Position,TPhysicsScalar Radius,bool Static,TPhysicsScalar Friction);
+	u16				GetCount() const								{	return mCount;	}
+	u16				GetBatchedCount() const							{	return (mCount + PHYSICS_BODY_BATCH-1) & ~(PHYSICS_BODY_BATCH-1);	}
+	void			Clear()											{	mCount = 0;	}
+
+	TPhysicsPoint	GetPosition(u16 Body) const						{	return TPhysicsPoint( mPositionX[Body], mPositionY[Body] );	}
+	TPhysicsPoint	GetVelocity(u16 Body) const						{	return TPhysicsPoint( mVelocityX[Body], mVelocityY[Body] );	}
+	TPhysicsPoint	GetForce(u16 Body) const						{	return TPhysicsPoint( mForceX[Body], mForceY[Body] );	}
+	TCollisionShape	GetWorldCollisionShape(u16 Body) const;
+	void			AddForce(u16 Body,const TPhysicsPoint& Force)	{	mForceX[Body] += Force.x;	mForceY[Body] += Force.y;	}
+	void			SetStatic(u16 Body,bool Static)					{	mStatic[Body] = Static;	}
+
+	void			ApplyForces();		//	velocity += force, then clear the force
+	void			Integrate();		//	position += velocity, then apply friction to the velocity
+
+private:
+	void			ResetBody(u16 Body);
+
+public:
+	u16				mCount;
+	TPhysicsScalar	mPositionX[MAX_PHYSICS_BODIES];
+	TPhysicsScalar	mPositionY[MAX_PHYSICS_BODIES];
+	TPhysicsScalar	mVelocityX[MAX_PHYSICS_BODIES];
+	TPhysicsScalar	mVelocityY[MAX_PHYSICS_BODIES];
+	TPhysicsScalar	mForceX[MAX_PHYSICS_BODIES];
+	TPhysicsScalar	mForceY[MAX_PHYSICS_BODIES];
+	TPhysicsScalar	mRadius[MAX_PHYSICS_BODIES];
+	TPhysicsScalar	mDamping[MAX_PHYSICS_BODIES];	//	1-friction, velocity is multiplied by this every frame
+	bool			mStatic[MAX_PHYSICS_BODIES];	//	if static, object will not move
+};
+
+struct TIntersection
+{
+	TPhysicsPoint	mMidPoint;
+	TPhysicsScalar	mDistance;
+	TPhysicsPoint	mIntersection;
+	TPhysicsPoint	mOtherIntersection;
+	TPhysicsScalar	mForceWeight;		//	intersection weight 0..1 0.5/0.5	if both objects have the same force impant
+};
+
+class TCollisionTest
+{
+public:
+	TCollisionTest() :
+		mBodyA		( 0xffff ),
+		mBodyB		( 0xffff ),
+		mHit		( false )
+	{
+	}
+	TCollisionTest(u16 BodyA,u16 BodyB) :
+		mBodyA		( BodyA ),
+		mBodyB		( BodyB ),
+		mHit		( false )
+	{
+	}
+
+	bool		IsValid() const		{	return (mBodyA != 0xffff) && (mBodyB != 0xffff);	}
+
+public:
+	u16			mBodyA;
+	u16			mBodyB;
+
+	bool		mHit;				//	was hit?
+
+	//TPointf		mHitPosition;		//	world space
+	//TPointf		mResponseForceA;	//	force to apply to object A
+	//TPointf		mResponseForceB;	//	force to apply to object A
+	TIntersection	mIntersectionA;
+	TIntersection	mIntersectionB;
+	TPhysicsPoint	mDiff;				//	B-A when the intersection was worked out, so cached contacts know how far they've moved
+};
+
+//	pairs the narrowphase filters in one go, longer lists are done in chunks
+#if !defined(NARROWPHASE_MAX_PAIRS)
+#define NARROWPHASE_MAX_PAIRS	1024
+#endif
+
+//	batched narrowphase. Snapshots every body's world position then runs the distance squared
+//	rejection over a list of candidate pairs several at a time (AVX2 or SSE on the host, scalar on
+//	the arduino). Only pairs that might touch go through DoCollision for the full contact
+class TNarrowphase
+{
+public:
+	void			Snapshot(const TPhysicsBodies& Bodies);
+	u16				FindTouchingPairs(const u16* BodyA,const u16* BodyB,u16 PairCount,TPhysicsScalar Margin,u16* Touching) const;	//	returns number of indexes written to Touching
+	u16				DoCollisions(TPhysicsBodies& Bodies,TCollisionTest* Tests,u16 TestCount,TPhysicsScalar Margin);	//	returns number of hits
+
+	static const char*	GetKernelName();
+
+public:
+	u16				mCount;
+	TPhysicsScalar	mWorldX[MAX_PHYSICS_BODIES];
+	TPhysicsScalar	mWorldY[MAX_PHYSICS_BODIES];
+	TPhysicsScalar	mRadius[MAX_PHYSICS_BODIES];
+
+	u16				mPairA[NARROWPHASE_MAX_PAIRS];		//	scratch for DoCollisions
+	u16				mPairB[NARROWPHASE_MAX_PAIRS];
+	u16				mTouching[NARROWPHASE_MAX_PAIRS];
+};
+
+//	contact solver settings. Islands stop iterating once their deepest overlap is under the settled
+//	depth, and the whole solve stops when it's used up its budget of pair tests for the frame
+#if !defined(CONTACT_SOLVER_ITERATIONS)
+#define CONTACT_SOLVER_ITERATIONS	4
+#endif
+#define CONTACT_SOLVER_BUDGET		256		//	pair tests per frame, on top of the first pass
+#define CONTACT_SOLVER_SETTLED		0.5f	//	overlap in pixels we're happy to leave
+
+//	re-runs the contacts that hit, grouped into islands of bodies touching each other, so crowds
+//	get pushed apart over a few iterations without re-testing piles that have already settled
+class TContactSolver
+{
+public:
+	TContactSolver() :
+		mIterations		( CONTACT_SOLVER_ITERATIONS ),
+		mBudget			( CONTACT_SOLVER_BUDGET ),
+		mSettledDepth	( CONTACT_SOLVER_SETTLED ),
+		mIslandCount	( 0 ),
+		mIterationCount	( 0 ),
+		mTestCount		( 0 )
+	{
+	}
+
+	void			Solve(TPhysicsBodies& Bodies,TCollisionTest* Tests,const u16* HitTests,u16 HitCount);	//	HitTests are indexes of Tests that hit in the first pass
+
+private:
+	u16				FindIsland(u16 Body);
+	void			BuildIslands(const TPhysicsBodies& Bodies,const TCollisionTest* Tests,const u16* HitTests,u16 HitCount);
+	TPhysicsScalar	GetDepth(const TPhysicsBodies& Bodies,const TCollisionTest& Test) const;
+
+public:
+	u8				mIterations;		//	max iterations after the first pass
+	u16				mBudget;
+	TPhysicsScalar	mSettledDepth;
+
+	u16				mIslandCount;		//	stats for the last solve
+	u8				mIterationCount;
+	u16				mTestCount;
+
+private:
+	u16				mIslandParent[MAX_PHYSICS_BODIES];		//	union-find, a body's parent on the way to its island's root
+	u16				mRootIsland[MAX_PHYSICS_BODIES];		//	island index of each root body
+	BufferArray<u16,NARROWPHASE_MAX_PAIRS>		mHitIsland;		//	island of each hit test
+	BufferArray<u16,NARROWPHASE_MAX_PAIRS+1>	mIslandFirst;	//	index into mIslandTests for each island (+1 tail)
+	BufferArray<u16,NARROWPHASE_MAX_PAIRS>		mIslandTests;	//	hit tests sorted by island
+	BufferArray<u16,NARROWPHASE_MAX_PAIRS>		mActiveIslands;	//	islands still moving
+};
+
+//	contact cache settings. Pairs are kept while they're within the skin of touching, and a body is
+//	only paired up again once it's moved half the skin from where it was last paired
+#if !defined(CONTACT_CACHE_SKIN)
+#define CONTACT_CACHE_SKIN		8		//	pixels
+#endif
+#if !defined(CONTACT_CACHE_REUSE)
+#define CONTACT_CACHE_REUSE		0.25f	//	contacts that moved less than this reuse last frame's intersection
+#endif
+
+//	pairs of bodies near enough to touch, carried from frame to frame and sorted by body pair so they
+//	come out in the same order as the brute force broadphase. The pairs live in the caller's list of
+//	collision tests, which it has to keep between frames (and Clear() the cache if it empties it).
+//	Pairing and testing work follows what's changed: only moved bodies are paired again, and contacts
+//	from last frame that have barely moved reuse last frame's intersection instead of working it out again
+class TContactCache
+{
+public:
+	TContactCache();
+
+	u16				Update(const TPhysicsBodies& Bodies,TCollisionTest* Tests,u16 TestCount,u16 MaxTests,const u16* CollideBodies,u16 CollideCount,TPhysicsScalar Margin);	//	returns the new number of tests
+	u16				DoCollisions(TPhysicsBodies& Bodies,TNarrowphase& Narrowphase,TCollisionTest* Tests,u16 TestCount,TPhysicsScalar Margin);	//	returns number of hits
+	void			Clear();
+
+private:
+	void			AddPairs(const TPhysicsBodies& Bodies,u16 Body,const u16* CollideBodies,u16 CollideCount,TPhysicsScalar Margin,u16 MaxNewPairs,bool AddTouching,bool AddSkin);
+
+public:
+	TPhysicsScalar	mSkin;
+	TPhysicsScalar	mReuseDistance;
+
+	u16				mMovedBodies;		//	stats for the last frame
+	u16				mNewPairs;
+	u16				mLostPairs;			//	touching pairs there was no room for, they're picked up again when there is
+	u16				mDeferredPairs;		//	pairs only in the skin there was no room for
+	u16				mPairChecks;		//	distance checks pairing the moved bodies
+	u16				mHitCount;
+	u16				mCachedHits;		//	hits on pairs carried over from last frame
+	u16				mReusedHits;		//	hits that reused last frame's intersection
+
+private:
+	BufferArray<u32,NARROWPHASE_MAX_PAIRS>	mNewKeys;	//	(BodyA<<16)|BodyB of pairs found this frame
+	TPhysicsScalar	mPairedX[MAX_PHYSICS_BODIES];		//	where each body was when it was last paired
+	TPhysicsScalar	mPairedY[MAX_PHYSICS_BODIES];
+	bool			mPaired[MAX_PHYSICS_BODIES];		//	body's pairs are in the cache
+	bool			mMoved[MAX_PHYSICS_BODIES];			//	paired again this frame
+	bool			mColliding[MAX_PHYSICS_BODIES];		//	in this frame's list of bodies
+};
+
+
+bool	GetIntersection(TCollisionShape& a,TCollisionShape& b,TIntersection& NodeAIntersection,TIntersection& NodeBIntersection);
+void	OnCollision(TPhysicsBodies& Bodies,u16 Body,const TIntersection& Intersection);
+void	DoCollision(TPhysicsBodies& Bodies,TCollisionTest& CollisionTest);
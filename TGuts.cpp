@@ -2,46 +2,159 @@
 
 #define MAX_DEPTH	0xffff
 
+//	depth rebuilds bucket on sprite y (9 bits), anything deeper is insertion sorted afterwards
+#define SPRITE_DEPTH_BUCKETS	512
 
+//	once this fraction (1/n) of sprites have changed depth in a frame, stop bubbling them into
+//	place and rebuild the depth order in one go when baking
+#define SPRITE_DEPTH_REBUILD_FRACTION	4
 
+//	write just the changed half of a sprite (X & palette or Y & image) rather than all 4 bytes
+#if !defined(SPRITE_FIELD_WRITES)
+#define SPRITE_FIELD_WRITES	1
+#endif
 
-TSpritePool::TSpritePool(bool DefferedBake) :
+//	queue vram writes and send them in address order at vblank, rather than as they're made
+#if !defined(VRAM_WRITE_QUEUE)
+#define VRAM_WRITE_QUEUE	1
+#endif
+
+
+
+
+TSpritePool::TSpritePool(bool DefferedBake,bool DoubleBuffered) :
 	mDefferedBake		( DefferedBake ),
-	mDebug_ChangeCount	( 0 )
+	mDoubleBuffered		( DoubleBuffered ),
+	mBackPage			( DoubleBuffered ? 1 : 0 ),
+	mDebug_ChangeCount	( 0 ),
+	mDebug_ReorderWrites	( 0 ),
+	mDebug_ReorderSaved	( 0 ),
+	mHardwareOrderDirty	( false ),
+	mDepthOrderDirty	( false ),
+	mDepthMoveCount		( 0 ),
+	mDebug_IncrementalDepthMoves	( 0 ),
+	mDebug_DepthRebuilds	( 0 ),
+	mHardwareSpriteRefs	( 256 )
 {
 	for ( int i=0;	i<256;	i++ )
-		mFreeSprites.PushBack(i);
+		mFreeSprites.Set(i);
+
+	//	immediate writes would go straight into the back page and never be replayed into the other one
+	assert( mDefferedBake || !mDoubleBuffered, "Double buffered sprite pages need a deffered bake" );
 }
 
 void TSpritePool::BakeHardwareSprite(const TSpriteRef& Sprite)
 {
-	assert( Sprite.IsValid(), "Sprite invalid" );
+	assert( IsSpriteAllocated( Sprite ), "Sprite invalid or stale" );
 	auto& SpriteDef = mSprites[Sprite.GetIndex()];
 	auto& SpriteDepth = mDepthInfo[SpriteDef.mDepthIndex];
-	TGameDuino::SetSprite( SpriteDepth.mHardwareSprite, SpriteDef.mCache );
+	u8& Fields = SpriteDef.mDirtyFields[mBackPage];
+#if SPRITE_FIELD_WRITES
+	TGameDuino::SetSpriteFields( SpriteDepth.mHardwareSprite, SpriteDef.mCache, Fields, mBackPage );
+#else
+	TGameDuino::SetSprite( SpriteDepth.mHardwareSprite, SpriteDef.mCache, mBackPage );
+#endif
+	Fields = 0;
 }
 
 void TSpritePool::BakeHardwareChanges(TFrameDebug& Debug)
 {
+	bool Rebuilt = mDepthOrderDirty;
+	RebuildSpriteDepths();
+	ReorderHardwareSprites();
+
+	//	the back page also needs whatever went into the front page last time
+	if ( mDoubleBuffered )
+	{
+		mUnflippedHardwareSprites.Merge( mChangedHardwareSprites );
+		mChangedHardwareSprites.Merge( mStaleHardwareSprites );
+		mStaleHardwareSprites.Clear();
+	}
+
 	if ( mDefferedBake )
-		mDebug_ChangeCount = mChangedSprites.GetSize();
+		mDebug_ChangeCount = mChangedHardwareSprites.GetCount();
+
+	//	bake in hardware sprite order, runs of consecutive sprites go out in one burst
+	for ( int h=mChangedHardwareSprites.FindNext(0);	h>=0;	h=mChangedHardwareSprites.FindNext(h+1) )
+	{
+		int RunLast = h;
+		while ( RunLast+1 < mChangedHardwareSprites.MaxSize() && mChangedHardwareSprites.IsSet(RunLast+1) )
+			RunLast++;
 
-	for ( int i=0;	i<mChangedSprites.GetSize();	i++ )
-		BakeHardwareSprite( mChangedSprites[i] );
+		if ( RunLast == h )
+		{
+			const TSpriteRef& Sprite = mHardwareSpriteRefs[h];
+			if ( !Sprite.IsValid() )
+			{
+				TGameDuino::HideSprite( h, mBackPage );
+				continue;
+			}
+			assert( mDepthInfo[ mSprites[Sprite.GetIndex()].mDepthIndex ].mHardwareSprite == h, "Changed sprite has moved hardware sprite without being flagged" );
+			BakeHardwareSprite( Sprite );
+			continue;
+		}
+
+		TGameDuino::BeginSpriteBurst( h, mBackPage );
+		for ( ;	h<=RunLast;	h++ )
+		{
+			const TSpriteRef& Sprite = mHardwareSpriteRefs[h];
+			if ( !Sprite.IsValid() )
+			{
+				TGameDuino::BurstHiddenSprite();
+				continue;
+			}
+			auto& SpriteDef = mSprites[Sprite.GetIndex()];
+			assert( mDepthInfo[ SpriteDef.mDepthIndex ].mHardwareSprite == h, "Changed sprite has moved hardware sprite without being flagged" );
+			TGameDuino::BurstSprite( SpriteDef.mCache );
+			SpriteDef.mDirtyFields[mBackPage] = 0;
+		}
+		TGameDuino::EndSpriteBurst();
+		h = RunLast;
+	}
 	
-	mChangedSprites.Clear();
+	mChangedHardwareSprites.Clear();
 
 	auto& DebugString = Debug.PushBackString();
 	DebugString << "Sprite Changes: " << mDebug_ChangeCount << "       ";
 
+	auto& ReorderString = Debug.PushBackString();
+	ReorderString << "Reorder: " << mDebug_ReorderWrites << " -" << mDebug_ReorderSaved << "     ";
+
+	auto& DepthString = Debug.PushBackString();
+	DepthString << "Depth: " << mDepthMoveCount << (Rebuilt ? " rebuild" : " bubble") << "    ";
+
+	mDepthMoveCount = 0;
 	mDebug_ChangeCount = 0;
+	mDebug_ReorderWrites = 0;
+	mDebug_ReorderSaved = 0;
 }
 
-void TSpritePool::OnSpriteChanged(const TSpriteRef& Sprite)
+void TSpritePool::FlipHardwarePages()
 {
+	if ( !mDoubleBuffered )
+		return;
+
+	//	show what we baked, and whatever we baked needs replaying into the new back page
+	TGameDuino::ShowSpritePage( mBackPage );
+	mBackPage ^= 1;
+	mStaleHardwareSprites = mUnflippedHardwareSprites;
+	mUnflippedHardwareSprites.Clear();
+}
+
+void TSpritePool::OnSpriteChanged(const TSpriteRef& Sprite,u8 Fields)
+{
+	//	every page needs these fields re-writing
+	auto& SpriteDef = mSprites[Sprite.GetIndex()];
+	for ( int p=0;	p<(mDoubleBuffered ? GD_SPRITE_PAGE_COUNT : 1);	p++ )
+		SpriteDef.mDirtyFields[p] |= Fields;
+
 	if ( mDefferedBake )
 	{
-		mChangedSprites.PushBackUnique( Sprite );
+		//	flag the sprite's current hardware sprite. Anything that changes which hardware
+		//	sprite a sprite uses flags it again, so the ref here is always the current owner
+		u8 HardwareSprite = mDepthInfo[ SpriteDef.mDepthIndex ].mHardwareSprite;
+		mChangedHardwareSprites.Set( HardwareSprite );
+		mHardwareSpriteRefs[HardwareSprite] = Sprite;
 	}
 	else
 	{
@@ -50,71 +163,226 @@ void TSpritePool::OnSpriteChanged(const TSpriteRef& Sprite)
 	}
 }
 
-void TSpritePool::MoveSpriteDepth(u16 FromIndex,u16 ToIndex,bool ForceHardwareAlignment)
+void TSpritePool::OnHardwareSpriteFreed(u8 HardwareSprite)
+{
+	mFreeSprites.Set( HardwareSprite );
+	if ( mDefferedBake )
+	{
+		//	no owner, so the bake hides it
+		mChangedHardwareSprites.Set( HardwareSprite );
+		mHardwareSpriteRefs[HardwareSprite] = TSpriteRef();
+	}
+	else
+	{
+		TGameDuino::HideSprite( HardwareSprite, mBackPage );
+		mDebug_ChangeCount++;
+	}
+}
+
+bool TSpritePool::IsHardwareSpriteOrdered(u16 DepthIndex) const
+{
+	u8 HardwareSprite = mDepthInfo[DepthIndex].mHardwareSprite;
+	if ( DepthIndex > 0 && mDepthInfo[DepthIndex-1].mHardwareSprite > HardwareSprite )
+		return false;
+	if ( DepthIndex < mDepthInfo.GetTailIndex() && mDepthInfo[DepthIndex+1].mHardwareSprite < HardwareSprite )
+		return false;
+	return true;
+}
+
+void TSpritePool::MoveSpriteDepth(u16 FromIndex,u16 ToIndex)
 {
 	//	no change to depth data
-	if ( FromIndex != ToIndex )
+	if ( FromIndex == ToIndex )
+		return;
+
+	//	save a copy of the depth info (will get overridden when shifted)
+	TSpriteDepthInfo DepthInfo = mDepthInfo[FromIndex];
+
+	//	shift depth array
+	if ( FromIndex > 0 && ToIndex < FromIndex )
 	{
-		//	save a copy of the depth info (will get overridden when shifted)
-		TSpriteDepthInfo DepthInfo = mDepthInfo[FromIndex];
+		ShiftSpriteDepthsDown( ToIndex, FromIndex-1 );
+	}
+	else if ( ToIndex > FromIndex )
+	{
+		ShiftSpriteDepthsUp( FromIndex+1, ToIndex );
+	}
 
-		//	shift depth array
-		if ( FromIndex > 0 && ToIndex < FromIndex )
-		{
-			ShiftSpriteDepthsDown( ToIndex, FromIndex-1 );
-		}
-		else if ( ToIndex > FromIndex )
-		{
-			ShiftSpriteDepthsUp( FromIndex+1, ToIndex );
-		}
+	//	place in moving depth info
+	auto& NewDepthInfo = mDepthInfo[ToIndex];
+	NewDepthInfo = DepthInfo;
+	mSprites[DepthInfo.mSpriteRef.GetIndex()].mDepthIndex = ToIndex;
 
-		//	place in moving depth info
-		auto& NewDepthInfo = mDepthInfo[ToIndex];
-		NewDepthInfo = DepthInfo;
-		mSprites[DepthInfo.mSpriteRef.GetIndex()].mDepthIndex = ToIndex;
-		OnSpriteChanged( DepthInfo.mSpriteRef );
+	//	hardware sprites are re-ordered in one go (at bake time if deffered)
+	if ( !IsHardwareSpriteOrdered( ToIndex ) )
+		mHardwareOrderDirty = true;
 
-		Debug_VerifySync( false, true );
+	if ( !mDefferedBake )
+		ReorderHardwareSprites();
+
+	Debug_VerifySync( !mHardwareOrderDirty, !mDepthOrderDirty );
+}
+
+//	re-sort all the depth info in one pass when lots of sprites have moved, rather than
+//	bubbling each one through its neighbours
+void TSpritePool::RebuildSpriteDepths()
+{
+	if ( !mDepthOrderDirty )
+		return;
+	mDepthOrderDirty = false;
+	mDebug_DepthRebuilds++;
+
+	//	counting sort, stable so sprites at the same depth keep their order (and hardware sprites)
+	u16 First[SPRITE_DEPTH_BUCKETS+1];
+	for ( int b=0;	b<SPRITE_DEPTH_BUCKETS+1;	b++ )
+		First[b] = 0;
+	for ( int d=0;	d<mDepthInfo.GetSize();	d++ )
+		First[ min( mDepthInfo[d].mDepth, SPRITE_DEPTH_BUCKETS-1 ) + 1 ]++;
+	for ( int b=0;	b<SPRITE_DEPTH_BUCKETS;	b++ )
+		First[b+1] += First[b];
+
+	static BufferArray<TSpriteDepthInfo,256> Sorted;
+	Sorted.SetSize( mDepthInfo.GetSize() );
+	for ( int d=0;	d<mDepthInfo.GetSize();	d++ )
+		Sorted[ First[ min( mDepthInfo[d].mDepth, SPRITE_DEPTH_BUCKETS-1 ) ]++ ] = mDepthInfo[d];
+
+	//	the last bucket holds everything deeper, which still needs ordering
+	for ( int d=First[SPRITE_DEPTH_BUCKETS-2]+1;	d<Sorted.GetSize();	d++ )
+	{
+		TSpriteDepthInfo DepthInfo = Sorted[d];
+		int e = d;
+		for ( ;	e>First[SPRITE_DEPTH_BUCKETS-2] && Sorted[e-1].mDepth > DepthInfo.mDepth;	e-- )
+			Sorted[e] = Sorted[e-1];
+		Sorted[e] = DepthInfo;
 	}
 
-	//	re-align hardware sprites (sometimes forced when a new sprite is introduced
-	if ( ForceHardwareAlignment || FromIndex != ToIndex )
+	for ( int d=0;	d<Sorted.GetSize();	d++ )
 	{
+		mDepthInfo[d] = Sorted[d];
+		mSprites[ Sorted[d].mSpriteRef.GetIndex() ].mDepthIndex = d;
+		if ( !IsHardwareSpriteOrdered( d ) )
+			mHardwareOrderDirty = true;
+	}
+
+	Debug_VerifySync( !mHardwareOrderDirty, true );
+}
+
+//	give the depth-sorted sprites increasing hardware sprites, rewriting as few as possible.
+//	A sprite can keep its hardware sprite if, between it and the previous sprite that keeps
+//	its own, there are enough hardware sprites for everything in between. That's true when
+//	(HardwareSprite - DepthIndex) doesn't go down, so the sprites to keep are the longest
+//	non-decreasing subsequence of that value and everything else is packed into the gaps.
+//	Moving into a gap means hiding the hardware sprite we left, so if sorting the hardware
+//	sprites we already have is cheaper (eg. two neighbours swapping) we do that instead.
+void TSpritePool::ReorderHardwareSprites()
+{
+	if ( !mHardwareOrderDirty )
+		return;
+	mHardwareOrderDirty = false;
 
-		//	re-order hardware sprites
-		//	bubble sort our new hardware sprite
-		int NewHardwareSpriteIndex = ToIndex;
-		for ( ; NewHardwareSpriteIndex>0;	NewHardwareSpriteIndex-- )
+	int Count = mDepthInfo.GetSize();
+	int MaxSlack = 256 - Count;
+
+	//	patience sort; Tails[k] is the depth index ending the best subsequence of length k+1
+	BufferArray<u8,256> Tails;
+	BufferArray<s16,256> Previous( Count );
+	for ( int i=0;	i<Count;	i++ )
+	{
+		int Slack = mDepthInfo[i].mHardwareSprite - i;
+		Previous[i] = -1;
+		//	can't keep this one whatever happens, not enough hardware sprites above or below it
+		if ( Slack < 0 || Slack > MaxSlack )
+			continue;
+
+		//	first tail with a bigger slack
+		int Low = 0;
+		int High = Tails.GetSize();
+		while ( Low < High )
 		{
-			auto& NewDepth = mDepthInfo[NewHardwareSpriteIndex];
-			auto& PrevDepth = mDepthInfo[NewHardwareSpriteIndex-1];
-			if ( NewDepth.mHardwareSprite > PrevDepth.mHardwareSprite )
-				break;
-
-			//	bubble-swap
-			u8 Temp = PrevDepth.mHardwareSprite;
-			PrevDepth.mHardwareSprite = NewDepth.mHardwareSprite;
-			NewDepth.mHardwareSprite = Temp;
-			OnSpriteChanged( PrevDepth.mSpriteRef );
-			OnSpriteChanged( NewDepth.mSpriteRef );
+			int Mid = (Low + High) / 2;
+			int MidSlack = mDepthInfo[Tails[Mid]].mHardwareSprite - Tails[Mid];
+			if ( MidSlack <= Slack )
+				Low = Mid + 1;
+			else
+				High = Mid;
 		}
-		for ( ; NewHardwareSpriteIndex<mDepthInfo.GetTailIndex();	NewHardwareSpriteIndex++ )
+
+		Previous[i] = (Low > 0) ? Tails[Low-1] : -1;
+		if ( Low == Tails.GetSize() )
+			Tails.PushBack( i );
+		else
+			Tails[Low] = i;
+	}
+
+	BufferBits<256> Keep;
+	for ( int i=Tails.IsEmpty() ? -1 : Tails[Tails.GetTailIndex()];	i>=0;	i=Previous[i] )
+		Keep.Set( i );
+
+	//	pack everything else in after the previous sprite we kept
+	BufferArray<u8,256> Packed( Count );
+	BufferBits<256> UsedBefore;
+	BufferBits<256> UsedAfter;
+	int PackedWrites = 0;
+	int NextHardwareSprite = 0;
+	for ( int i=0;	i<Count;	i++ )
+	{
+		u8 HardwareSprite = mDepthInfo[i].mHardwareSprite;
+		if ( !Keep.IsSet(i) )
 		{
-			auto& NewDepth = mDepthInfo[NewHardwareSpriteIndex];
-			auto& NextDepth = mDepthInfo[NewHardwareSpriteIndex+1];
-			if ( NewDepth.mHardwareSprite < NextDepth.mHardwareSprite )
-				break;
-
-			//	bubble-swap
-			u8 Temp = NextDepth.mHardwareSprite;
-			NextDepth.mHardwareSprite = NewDepth.mHardwareSprite;
-			NewDepth.mHardwareSprite = Temp;
-			OnSpriteChanged( NextDepth.mSpriteRef );
-			OnSpriteChanged( NewDepth.mSpriteRef );
+			assert( NextHardwareSprite < 256, "Ran out of hardware sprites re-ordering" );
+			HardwareSprite = NextHardwareSprite;
 		}
+		Packed[i] = HardwareSprite;
+		UsedBefore.Set( mDepthInfo[i].mHardwareSprite );
+		UsedAfter.Set( HardwareSprite );
+		NextHardwareSprite = HardwareSprite + 1;
+		if ( HardwareSprite != mDepthInfo[i].mHardwareSprite )
+			PackedWrites++;
+	}
+
+	//	hardware sprites we move off have to be hidden, which costs a write too
+	int Vacated = 0;
+	for ( int h=UsedBefore.FindNext(0);	h>=0;	h=UsedBefore.FindNext(h+1) )
+		if ( !UsedAfter.IsSet(h) )
+			Vacated++;
+	PackedWrites += Vacated;
+
+	//	the alternative is to sort the hardware sprites we already use, which is what bubbling
+	//	them used to do. Nothing needs hiding, so for a single swap it's cheaper
+	int SortedWrites = 0;
+	for ( int i=0,h=UsedBefore.FindNext(0);	i<Count;	i++,h=UsedBefore.FindNext(h+1) )
+		if ( mDepthInfo[i].mHardwareSprite != h )
+			SortedWrites++;
+
+	int Writes = 0;
+	if ( SortedWrites <= PackedWrites )
+	{
+		for ( int i=0,h=UsedBefore.FindNext(0);	i<Count;	i++,h=UsedBefore.FindNext(h+1) )
+			Packed[i] = h;
+		Writes = SortedWrites;
+	}
+	else
+	{
+		//	hide hardware sprites nothing uses any more
+		for ( int h=UsedBefore.FindNext(0);	h>=0;	h=UsedBefore.FindNext(h+1) )
+			if ( !UsedAfter.IsSet(h) )
+				OnHardwareSpriteFreed( h );
+		for ( int h=UsedAfter.FindNext(0);	h>=0;	h=UsedAfter.FindNext(h+1) )
+			mFreeSprites.Unset( h );
+		Writes = PackedWrites;
+	}
+
+	for ( int i=0;	i<Count;	i++ )
+	{
+		auto& DepthInfo = mDepthInfo[i];
+		if ( DepthInfo.mHardwareSprite == Packed[i] )
+			continue;
+		DepthInfo.mHardwareSprite = Packed[i];
+		OnSpriteChanged( DepthInfo.mSpriteRef, TSpriteField::Slot );
 	}
 
-	Debug_VerifySync();
+	mDebug_ReorderWrites += Writes;
+	mDebug_ReorderSaved += SortedWrites - Writes;
 }
 
 void TSpritePool::ShiftSpriteDepthsDown(u16 First,u16 Last)
@@ -140,8 +408,7 @@ void TSpritePool::ShiftSpriteDepthsDown(u16 First,u16 Last)
 		//	to new index
 		SpriteDef.mDepthIndex = ToIndex;
 
-		//	notify change (hardware sprite has changed)
-		OnSpriteChanged( DepthTo.mSpriteRef );
+		//	hardware sprite goes with the depth info so nothing to re-bake
 	}
 }
 
@@ -168,24 +435,55 @@ void TSpritePool::ShiftSpriteDepthsUp(u16 First,u16 Last)
 		//	to new index
 		SpriteDef.mDepthIndex = ToIndex;
 
-		//	notify change (hardware sprite has changed)
-		OnSpriteChanged( DepthTo.mSpriteRef );
+		//	hardware sprite goes with the depth info so nothing to re-bake
 	}
 }
 
-u8 TSpritePool::AllocSpriteDepth(u16 Depth,const TSpriteRef& SpriteRef,u8 HardwareSprite)
+u8 TSpritePool::AllocHardwareSprite(u16 DepthIndex)
 {
-	//	find where to insert new depth with binary chop
-	//	todo: binary chop
-	int Index;
-	for ( Index=0;	Index<mDepthInfo.GetSize();	Index++ )
+	//	try and fit between the sprites either side of where we're going so nothing has to be re-ordered,
+	//	going for the middle of the gap to leave room either side
+	int Prev = (DepthIndex > 0) ? mDepthInfo[DepthIndex-1].mHardwareSprite : -1;
+	int Next = (DepthIndex < mDepthInfo.GetSize()) ? mDepthInfo[DepthIndex].mHardwareSprite : 256;
+	int HardwareSprite = -1;
+	if ( Prev < Next )
 	{
-		auto& DepthInfo = mDepthInfo[Index];
-		if ( Depth < DepthInfo.mDepth )
-			break;
+		HardwareSprite = mFreeSprites.FindNext( (Prev + Next + 1) / 2 );
+		if ( HardwareSprite < 0 || HardwareSprite >= Next )
+			HardwareSprite = mFreeSprites.FindNext( Prev + 1 );
+		if ( HardwareSprite >= Next )
+			HardwareSprite = -1;
+	}
+
+	//	doesn't fit, any will do and it'll get re-ordered
+	if ( HardwareSprite < 0 )
+	{
+		HardwareSprite = mFreeSprites.FindNext( 0 );
+		mHardwareOrderDirty = true;
+	}
+
+	assert( HardwareSprite >= 0, "No free hardware sprites" );
+	mFreeSprites.Unset( HardwareSprite );
+	return static_cast<u8>( HardwareSprite );
+}
+
+u8 TSpritePool::AllocSpriteDepth(u16 Depth,const TSpriteRef& SpriteRef)
+{
+	//	find where to insert new depth with binary chop (after any at the same depth)
+	//	if the depth order is waiting for a rebuild it doesn't matter where we go
+	int Index = 0;
+	int High = mDepthInfo.GetSize();
+	while ( Index < High )
+	{
+		int Mid = (Index + High) / 2;
+		if ( mDepthInfo[Mid].mDepth <= Depth )
+			Index = Mid + 1;
+		else
+			High = Mid;
 	}
 	
 	assert( Index <= mDepthInfo.GetSize(), "shouldn't be greater" );
+	u8 HardwareSprite = AllocHardwareSprite( Index );
 
 	//	add a tail
 	auto& NewDepthInfo = mDepthInfo.PushBack();
@@ -195,43 +493,55 @@ u8 TSpritePool::AllocSpriteDepth(u16 Depth,const TSpriteRef& SpriteRef,u8 Hardwa
 	mSprites[SpriteRef.GetIndex()].mDepthIndex = mDepthInfo.GetTailIndex();
 
 	//	move into place
-	MoveSpriteDepth( mDepthInfo.GetTailIndex(), Index, true );
+	MoveSpriteDepth( mDepthInfo.GetTailIndex(), Index );
+
+	if ( !mDefferedBake )
+		ReorderHardwareSprites();
 
 	assert( Index >= 0 && Index < 256, "Out of bounds" );
 	return static_cast<u8>( Index );
 }
 
-TSpriteRef TSpritePool::AllocSprite(const TSpriteInfo& Info)
+TSpriteRef TSpritePool::AllocSprite(const TSpriteInfo& Info,s16 DepthOffset)
 {
 	//	get a free hardware index...
 	if ( mFreeSprites.IsEmpty() )
 		return TSpriteRef();
 
-	//	grab a free sprite index
-	u8 HardwareSprite;
-	mFreeSprites.PopBack( HardwareSprite );
-
-	//	alloc a sprite def
-	TSpriteDef& SpriteDef = mSprites.PushBack();
+	//	alloc a sprite def, re-using a freed one if we can
+	u8 SpriteIndex;
+	if ( !mFreeSpriteDefs.IsEmpty() )
+	{
+		mFreeSpriteDefs.PopBack( SpriteIndex );
+	}
+	else
+	{
+		mSprites.PushBack();
+		SpriteIndex = static_cast<u8>( mSprites.GetTailIndex() );
+	}
+	TSpriteDef& SpriteDef = mSprites[SpriteIndex];
 	SpriteDef.mCache = Info;
+	SpriteDef.mDepthOffset = DepthOffset;
+	SpriteDef.mAllocated = true;
 	TSpriteRef SpriteRef;
-	SpriteRef.mIndex = static_cast<u8>( mSprites.GetTailIndex() );
+	SpriteRef.mIndex = SpriteIndex;
+	SpriteRef.mGeneration = SpriteDef.mGeneration;
 
 	//	alloc & init a sprite depth
-	u8 SpriteDepthIndex = AllocSpriteDepth( SpriteDef.mCache.GetDepth(), SpriteRef, HardwareSprite );
+	u8 SpriteDepthIndex = AllocSpriteDepth( SpriteDef.GetDepth(), SpriteRef );
 
 	//	sync depth & def
 	SpriteDef.mDepthIndex = SpriteDepthIndex;
 
 	OnSpriteChanged( SpriteRef );
-	Debug_VerifySync();
+	Debug_VerifySync( !mHardwareOrderDirty, !mDepthOrderDirty );
 
 	return SpriteRef;
 }
 
 void TSpritePool::SetSpriteDepth(const TSpriteRef& Sprite,u16 NewDepth)
 {
-	assert( Sprite.IsValid(), "Invalid sprite" );
+	assert( IsSpriteAllocated( Sprite ), "Invalid or stale sprite" );
 	
 	//	bubble-find where we want to be placed to cause minimum disruption
 	int CurrentDepthIndex = mSprites[Sprite.GetIndex()].mDepthIndex;
@@ -251,52 +561,243 @@ void TSpritePool::SetSpriteDepth(const TSpriteRef& Sprite,u16 NewDepth)
 	}
 
 	mDepthInfo[CurrentDepthIndex].mDepth = NewDepth;
-	MoveSpriteDepth( CurrentDepthIndex, NewDepthIndex, false );
+	MoveSpriteDepth( CurrentDepthIndex, NewDepthIndex );
 	
 }
 
 
+namespace
+{
+	const prog_uchar*	GetMetaspriteFrame(const prog_uchar* Table,u8 Frame)
+	{
+		const prog_uchar* FrameOffset = &Table[ 1 + (Frame * sizeof(u16)) ];
+		return &Table[ pgm_read_byte( &FrameOffset[0] ) | (pgm_read_byte( &FrameOffset[1] ) << 8) ];
+	}
+};
+
+u8 TMetasprite::GetFrameCount() const
+{
+	return pgm_read_byte( &mTable[0] );
+}
+
+u8 TMetasprite::GetPartCount(u8 Frame) const
+{
+	return pgm_read_byte( GetMetaspriteFrame( mTable, Frame ) );
+}
+
+TSpriteInfo TMetasprite::GetPart(u8 Frame,u8 Part) const
+{
+	const prog_uchar* PartData = GetMetaspriteFrame( mTable, Frame ) + 1 + (Part * 4);
+	s16 x = static_cast<s8>( pgm_read_byte( &PartData[0] ) );
+	s16 y = static_cast<s8>( pgm_read_byte( &PartData[1] ) );
+
+	//	same as GD.xsprite; flip, then swap for the diagonal
+	if ( mRotation & 2 )
+		x = -GD_SPRITE_WIDTH - x;
+	if ( mRotation & 4 )
+		y = -GD_SPRITE_HEIGHT - y;
+	if ( mRotation & 1 )
+	{
+		s16 Swap = x;
+		x = y;
+		y = Swap;
+	}
+
+	TPoint Position( mPosition.x + x, mPosition.y + y );
+	return TSpriteInfo( Position, pgm_read_byte( &PartData[2] ), pgm_read_byte( &PartData[3] ), mRotation );
+}
+
+bool TSpritePool::IsSpriteAllocated(const TSpriteRef& Sprite) const
+{
+	if ( !Sprite.IsValid() || Sprite.GetIndex() >= mSprites.GetSize() )
+		return false;
+	auto& SpriteDef = mSprites[Sprite.GetIndex()];
+	return SpriteDef.mAllocated && (SpriteDef.mGeneration == Sprite.mGeneration);
+}
+
 void TSpritePool::FreeSprite(const TSpriteRef& Sprite)
 {
-	assert(false,"todo");
+	assert( IsSpriteAllocated( Sprite ), "Freeing invalid or stale sprite" );
+	auto& SpriteDef = mSprites[Sprite.GetIndex()];
+	u16 DepthIndex = SpriteDef.mDepthIndex;
+	u8 HardwareSprite = mDepthInfo[DepthIndex].mHardwareSprite;
+
+	//	close the gap in the depth info. Everything keeps its hardware sprite so nothing needs re-baking
+	if ( DepthIndex < mDepthInfo.GetTailIndex() )
+		ShiftSpriteDepthsUp( DepthIndex+1, mDepthInfo.GetTailIndex() );
+	mDepthInfo.SetSize( mDepthInfo.GetSize()-1 );
+
+	//	hide and recycle the hardware sprite
+	OnHardwareSpriteFreed( HardwareSprite );
+
+	//	recycle the def, anything still holding a ref to it is now stale
+	SpriteDef.mAllocated = false;
+	SpriteDef.mDepthIndex = 0xff;
+	SpriteDef.mGeneration++;
+	mFreeSpriteDefs.PushBack( Sprite.GetIndex() );
+
+	Debug_VerifySync( !mHardwareOrderDirty, !mDepthOrderDirty );
 }
 
 void TSpritePool::MoveSprite(const TSpriteRef& Sprite,const TPoint& Position)
 {
-	assert( Sprite.IsValid(), "Invalid sprite" );
+	assert( IsSpriteAllocated( Sprite ), "Invalid or stale sprite" );
 
 	auto& SpriteDef = mSprites[Sprite.GetIndex()];
-	auto& SpriteDepth = mDepthInfo[SpriteDef.mDepthIndex];
 	
 	//	no change
 	if ( SpriteDef.mCache.mPosition == Position )
 		return;
 
+	u8 Fields = 0;
+	if ( SpriteDef.mCache.mPosition.x != Position.x )
+		Fields |= TSpriteField::X;
+	if ( SpriteDef.mCache.mPosition.y != Position.y )
+		Fields |= TSpriteField::Y;
+
 	//	change sprite info
-	u16 OldDepth = SpriteDepth.mDepth;
 	SpriteDef.mCache.mPosition = Position;
-	u16 NewDepth = SpriteDef.mCache.GetDepth();
-	if ( OldDepth != NewDepth )
+	OnSpriteDepthChanged( Sprite );
+	OnSpriteChanged( Sprite, Fields );
+}
+
+void TSpritePool::SetSprite(const TSpriteRef& Sprite,const TSpriteInfo& Info,s16 DepthOffset)
+{
+	assert( IsSpriteAllocated( Sprite ), "Invalid or stale sprite" );
+
+	auto& SpriteDef = mSprites[Sprite.GetIndex()];
+	auto& Cache = SpriteDef.mCache;
+	u8 Fields = 0;
+	if ( Cache.mPosition.x != Info.mPosition.x )
+		Fields |= TSpriteField::X;
+	if ( Cache.mPosition.y != Info.mPosition.y )
+		Fields |= TSpriteField::Y;
+	if ( Cache.mImage != Info.mImage )
+		Fields |= TSpriteField::Image;
+	if ( Cache.mPalette != Info.mPalette )
+		Fields |= TSpriteField::Palette;
+	if ( Cache.mRotation != Info.mRotation )
+		Fields |= TSpriteField::Rotation;
+
+	//	no change
+	if ( Fields == 0 && SpriteDef.mDepthOffset == DepthOffset )
+		return;
+
+	Cache = Info;
+	SpriteDef.mDepthOffset = DepthOffset;
+	OnSpriteDepthChanged( Sprite );
+	if ( Fields )
+		OnSpriteChanged( Sprite, Fields );
+}
+
+TMetasprite TSpritePool::AllocMetasprite(const prog_uchar* Table,const TPoint& Position,u8 Frame,u8 Rotation)
+{
+	TMetasprite Metasprite;
+	Metasprite.mTable = Table;
+	Metasprite.mPosition = Position;
+	Metasprite.mFrame = Frame;
+	Metasprite.mRotation = Rotation;
+	assert( Frame < Metasprite.GetFrameCount(), "Metasprite frame out of range" );
+
+	//	enough parts for the biggest frame so animating never allocates
+	u8 PartCount = 0;
+	for ( u8 f=0;	f<Metasprite.GetFrameCount();	f++ )
+		PartCount = max( PartCount, Metasprite.GetPartCount( f ) );
+	assert( PartCount <= METASPRITE_MAX_PARTS, "Metasprite has too many parts" );
+	if ( mFreeSprites.GetCount() < PartCount )
+		return TMetasprite();
+
+	for ( u8 p=0;	p<PartCount;	p++ )
+		Metasprite.mParts.PushBack( AllocSprite( TSpriteInfo() ) );
+	UpdateMetasprite( Metasprite );
+	return Metasprite;
+}
+
+void TSpritePool::FreeMetasprite(TMetasprite& Metasprite)
+{
+	for ( int p=0;	p<Metasprite.mParts.GetSize();	p++ )
+		FreeSprite( Metasprite.mParts[p] );
+	Metasprite = TMetasprite();
+}
+
+void TSpritePool::MoveMetasprite(TMetasprite& Metasprite,const TPoint& Position)
+{
+	Metasprite.mPosition = Position;
+	UpdateMetasprite( Metasprite );
+}
+
+void TSpritePool::SetMetaspriteFrame(TMetasprite& Metasprite,u8 Frame,u8 Rotation)
+{
+	assert( Frame < Metasprite.GetFrameCount(), "Metasprite frame out of range" );
+	Metasprite.mFrame = Frame;
+	Metasprite.mRotation = Rotation;
+	UpdateMetasprite( Metasprite );
+}
+
+void TSpritePool::UpdateMetasprite(TMetasprite& Metasprite)
+{
+	//	every part sorts at the metasprite's depth so other sprites can't get between them
+	u8 PartCount = Metasprite.GetPartCount( Metasprite.mFrame );
+	for ( u8 p=0;	p<Metasprite.mParts.GetSize();	p++ )
 	{
-		SetSpriteDepth( Sprite, NewDepth );
+		auto& Sprite = Metasprite.mParts[p];
+		if ( p < PartCount )
+		{
+			TSpriteInfo Part = Metasprite.GetPart( Metasprite.mFrame, p );
+			SetSprite( Sprite, Part, Metasprite.mPosition.y - Part.mPosition.y );
+		}
+		else
+		{
+			//	spare part, hide it
+			TSpriteInfo Hidden = mSprites[Sprite.GetIndex()].mCache;
+			Hidden.mPosition = TSpriteInfo().mPosition;
+			SetSprite( Sprite, Hidden );
+		}
 	}
+}
 
-	OnSpriteChanged( Sprite );
+void TSpritePool::OnSpriteDepthChanged(const TSpriteRef& Sprite)
+{
+	auto& SpriteDef = mSprites[Sprite.GetIndex()];
+	auto& SpriteDepth = mDepthInfo[SpriteDef.mDepthIndex];
+	u16 NewDepth = SpriteDef.GetDepth();
+	if ( SpriteDepth.mDepth == NewDepth )
+		return;
+
+	//	when lots of sprites are moving, leave them out of order and rebuild when baking
+	mDepthMoveCount++;
+	if ( mDefferedBake && mDepthMoveCount * SPRITE_DEPTH_REBUILD_FRACTION > mDepthInfo.GetSize() )
+		mDepthOrderDirty = true;
+
+	if ( mDepthOrderDirty )
+	{
+		SpriteDepth.mDepth = NewDepth;
+	}
+	else
+	{
+		SetSpriteDepth( Sprite, NewDepth );
+		mDebug_IncrementalDepthMoves++;
+	}
 }
 
 
 //	verify all arrays are sync'd up correctly
+//	this is O(n^2) so it's kept out of release builds
+#if defined(_DEBUG)
 void TSpritePool::Debug_VerifySync(bool CheckHardwareOrder,bool CheckDepthOrder)
 {
-	assert( mSprites.GetSize() == mDepthInfo.GetSize(), "Sprite arrays are different size" );
+	assert( mSprites.GetSize() - mFreeSpriteDefs.GetSize() == mDepthInfo.GetSize(), "Sprite arrays are different size" );
 
 	for ( int s=0;	s<mSprites.GetSize();	s++ )
 	{
 		auto& Sprite = mSprites[s];
+		if ( !Sprite.mAllocated )
+			continue;
 		assert( Sprite.mDepthIndex < mDepthInfo.GetSize(), "Sprite's depth index out of bounds" );
 		auto& SpriteDepth = mDepthInfo[Sprite.mDepthIndex];
 		assert( SpriteDepth.mSpriteRef.IsValid(), "Sprite's depth info has invalid sprite ref" );
 		assert( SpriteDepth.mSpriteRef.GetIndex() == s, "Sprite's depth info points at different sprite" );
+		assert( SpriteDepth.mSpriteRef.mGeneration == Sprite.mGeneration, "Sprite's depth info has a stale ref" );
 	}
 
 	for ( int d=0;	d<mDepthInfo.GetSize();	d++ )
@@ -307,6 +808,8 @@ void TSpritePool::Debug_VerifySync(bool CheckHardwareOrder,bool CheckDepthOrder)
 		auto& Sprite = mSprites[SpriteDepth.mSpriteRef.GetIndex()];
 		assert( Sprite.mDepthIndex == d, "Depth info's sprite points at different depth info" );
 
+		assert( !mFreeSprites.IsSet( SpriteDepth.mHardwareSprite ), "Used hardware sprite is in the free list" );
+
 		//	check no duplicates
 		for ( int e=d+1;	CheckHardwareOrder && e<mDepthInfo.GetSize();	e++ )
 		{
@@ -325,32 +828,116 @@ void TSpritePool::Debug_VerifySync(bool CheckHardwareOrder,bool CheckDepthOrder)
 		}
 	}
 }
+#endif
 
 void TGameDuino::SetMapPalette(const BufferArray<TColour16,4>& Palette,u8 FirstColour)
 {
-	/*
 	//	count = min( Palette.Size - FirstColour, 4 )
 	u16 Ram = RAM_PAL;
 	Ram += FirstColour * sizeof(TColour16);
-	GD.copy( Ram, const_cast<prog_uchar*>( Palette.GetRawData() ), Palette.GetDataSize() );
-	*/
-	for ( int i=0;	i<Palette.GetSize();	i++ )
-		GD.setpal( FirstColour+i, Palette[i].mRgba );
+	Write( Ram, Palette.GetRawData(), Palette.GetDataSize() );
 }
 
 void TGameDuino::SetMapScroll(const Type2<u16>& Pos)
 {
-	GD.wr16( SCROLL_X, Pos.x );
-	GD.wr16( SCROLL_Y, Pos.y );
+	Write16( SCROLL_X, Pos.x );
+	Write16( SCROLL_Y, Pos.y );
 }
 
+namespace TGameDuino
+{
+	TMapShadow	gMapShadow;
+};
+
 void TGameDuino::SetMap(const TBackgroundMap& Map)
 {
-	u8 MapX = 0;
-	u8 MapY = 0;
-	u16 Ram = RAM_PIC;
-	Ram += MapX + (MapY * GD_MAP_WIDTH);
-	GD.copy( Ram, const_cast<prog_uchar*>( Map.mMap.GetRawData() ), Map.mMap.GetDataSize() );
+	SetMapRegion( Map, 0, 0, GD_MAP_WIDTH, GD_MAP_HEIGHT );
+}
+
+void TGameDuino::SetMapRegion(const TBackgroundMap& Map,u8 x,u8 y,u8 Width,u8 Height)
+{
+	gMapShadow.SetRegion( Map, x, y, Width, Height );
+}
+
+void TGameDuino::SetMapCells(u8 x,u8 y,const u8* Cells,u8 Count)
+{
+	gMapShadow.SetCells( x, y, Cells, Count );
+}
+
+
+TMapShadow::TMapShadow() :
+	mDirtyRows	( GD_MAP_HEIGHT )
+{
+}
+
+void TMapShadow::SetCells(u8 x,u8 y,const u8* Cells,u8 Count)
+{
+	if ( y >= GD_MAP_HEIGHT || x >= GD_MAP_WIDTH )
+		return;
+	Count = min( Count, GD_MAP_WIDTH - x );
+
+	//	we don't know what's in a row until we've written all of it
+	bool Known = mKnownRows.IsSet( y );
+	auto& Span = mDirtyRows[y];
+	for ( u8 i=0;	i<Count;	i++ )
+	{
+		u8& Cell = mMap.mMap[ (x+i) + (y * GD_MAP_WIDTH) ];
+		if ( Known && Cell == Cells[i] )
+			continue;
+		Cell = Cells[i];
+		Span.Add( x+i );
+	}
+
+	if ( x == 0 && Count == GD_MAP_WIDTH )
+		mKnownRows.Set( y );
+}
+
+void TMapShadow::SetRegion(const TBackgroundMap& Map,u8 x,u8 y,u8 Width,u8 Height)
+{
+	if ( x >= GD_MAP_WIDTH )
+		return;
+	Width = min( Width, GD_MAP_WIDTH - x );
+	for ( u8 Row=y;	Row<GD_MAP_HEIGHT && Row-y<Height;	Row++ )
+		SetCells( x, Row, &Map.mMap[ x + (Row * GD_MAP_WIDTH) ], Width );
+}
+
+void TMapShadow::Flush()
+{
+	//	the queue joins up spans that run onto the next row
+	for ( int y=0;	y<mDirtyRows.GetSize();	y++ )
+	{
+		auto& Span = mDirtyRows[y];
+		if ( !Span.IsDirty() )
+			continue;
+		//	cleared before writing, a write that can't be queued flushes us again
+		u16 Index = Span.mFirst + (y * GD_MAP_WIDTH);
+		u16 Size = Span.mLast - Span.mFirst + 1;
+		Span.Clear();
+		TGameDuino::Write( RAM_PIC + Index, &mMap.mMap[Index], Size );
+	}
+}
+
+void TMapShadow::OnWriteNow(u16 Addr,const u8* Data,u16 Size)
+{
+	//	the hardware has these cells now, so known rows stay known
+	u16 MapSize = GD_MAP_WIDTH * GD_MAP_HEIGHT;
+	u16 Index = Addr - RAM_PIC;
+	if ( Index >= MapSize )
+		return;
+	Size = min( Size, MapSize - Index );
+	for ( u16 i=0;	i<Size;	i++ )
+		mMap.mMap[Index+i] = Data[i];
+}
+
+void TMapShadow::OnWriteNowProgmem(u16 Addr,const prog_uchar* Data,u16 Size)
+{
+	u16 MapSize = GD_MAP_WIDTH * GD_MAP_HEIGHT;
+	u16 Index = Addr - RAM_PIC;
+	if ( Index >= MapSize )
+		return;
+	Size = min( Size, MapSize - Index );
+	for ( u16 i=0;	i<Size;	i++ )
+		mMap.mMap[Index+i] = pgm_read_byte( &Data[i] );
 }
 
 
@@ -387,12 +974,24 @@ u8 TGameDuino::GetSpritePaletteMaxIndex(TSpritePal::Type PalType)
 	u8 PalMax[ TSpritePal::_Max ] = { 255, 15, 3 };
 	return PalMax[ PalType ];
 }
+
+u8 TGameDuino::GetSpritePaletteSelect(TSpritePal::Type PalType,u8 PaletteIndex,u8 Part)
+{
+	//	0-3 256 colour palettes, 4-7 16 colour (01NP), 8-15 4 colour (1NNP)
+	switch ( PalType )
+	{
+	default:
+	case TSpritePal::Pal256:	return PaletteIndex;
+	case TSpritePal::Pal16:		return 0x4 | ((Part & 0x1) << 1) | (PaletteIndex & 0x1);
+	case TSpritePal::Pal4:		return 0x8 | ((Part & 0x3) << 1) | (PaletteIndex & 0x1);
+	}
+}
 	
 void TGameDuino::SetSpritePalette(const BufferArray<TColour16,256>& Palette,TSpritePal::Type PalType,u8 PaletteIndex)
 {
 	u16 RamAddr = GetSpritePaletteRamAddr( PalType, PaletteIndex );
 	//u8 Count = min( GetSpritePaletteMaxCount(PalType)-PaletteIndex, Palette.GetSize() );
-	GD.copy( RamAddr + (PaletteIndex*sizeof(TColour16)), const_cast<prog_uchar*>( Palette.GetRawData() ), Palette.GetDataSize() );
+	Write( RamAddr, reinterpret_cast<const u8*>( Palette.GetRawData() ), Palette.GetDataSize() );
 }
 
 
@@ -402,7 +1001,7 @@ void TGameDuino::SetSpriteCharacter(const TSpriteCharacter& Character,u8 Index)
 	u16 RamAddr = RAM_SPRIMG;
 	RamAddr += Index * (GD_SPRITE_DATA_SIZE);
 	//RamAddr -= Index;
-	GD.copy( RamAddr, const_cast<prog_uchar*>( Character.mMap.GetData() ), Character.mMap.GetDataSize() );
+	Write( RamAddr, reinterpret_cast<const u8*>( Character.mMap.GetData() ), Character.mMap.GetDataSize() );
 }
 
 template<class ARRAY>
@@ -414,16 +1013,439 @@ void TGameDuino::SetSpriteCharacters(const ARRAY& Characters,u8 FirstIndex)
 	}
 }
 
-void TGameDuino::SetSprite(u8 SpriteIndex,const TSpriteInfo& Sprite)
+namespace TGameDuino
 {
-	GD.sprite( SpriteIndex, Sprite.mPosition.x, Sprite.mPosition.y, Sprite.mImage, Sprite.mPalette );
+	TBusStats	gBusStats;
+	TVramQueue	gVramQueue;
+	u16			gBurstAddr = 0;
+
+	//	same layout GD.sprite() writes (no collision class)
+	void		GetSpriteWords(const TSpriteInfo& Sprite,u16& FirstWord,u16& SecondWord)
+	{
+		u16 x = Sprite.mPosition.x;
+		u16 y = Sprite.mPosition.y;
+		FirstWord = lowByte(x) | (((Sprite.mPalette << 4) | ((Sprite.mRotation & 0x7) << 1) | (highByte(x) & 1)) << 8);
+		SecondWord = lowByte(y) | (((Sprite.mImage << 1) | (highByte(y) & 1)) << 8);
+	}
+
+	u16			GetSpriteRamAddr(u8 SpriteIndex,u8 Page)
+	{
+		return RAM_SPR + (Page * GD_SPRITE_PAGE_SIZE) + (SpriteIndex * GD_SPRITE_RECORD_SIZE);
+	}
+};
+
+void TGameDuino::SetSprite(u8 SpriteIndex,const TSpriteInfo& Sprite,u8 Page)
+{
+	u16 Words[2];
+	GetSpriteWords( Sprite, Words[0], Words[1] );
+	u8 Record[GD_SPRITE_RECORD_SIZE] = { lowByte(Words[0]), highByte(Words[0]), lowByte(Words[1]), highByte(Words[1]) };
+	Write( GetSpriteRamAddr( SpriteIndex, Page ), Record, sizeof(Record) );
 }
 
 
-void TGameDuino::HideSprite(u8 SpriteIndex)
+void TGameDuino::SetSpriteFields(u8 SpriteIndex,const TSpriteInfo& Sprite,u8 Fields,u8 Page)
+{
+	//	sprite is 2 words, x & palette & rotation then y & image
+	const u8 FirstWordFields = TSpriteField::X | TSpriteField::Palette | TSpriteField::Rotation;
+	const u8 SecondWordFields = TSpriteField::Y | TSpriteField::Image;
+	bool FirstWord = (Fields & FirstWordFields) != 0;
+	bool SecondWord = (Fields & SecondWordFields) != 0;
+	if ( (Fields & TSpriteField::Slot) || (FirstWord && SecondWord) )
+	{
+		SetSprite( SpriteIndex, Sprite, Page );
+		return;
+	}
+
+	u16 Words[2];
+	GetSpriteWords( Sprite, Words[0], Words[1] );
+	u16 RamAddr = GetSpriteRamAddr( SpriteIndex, Page );
+	if ( FirstWord )
+		Write16( RamAddr, Words[0] );
+	if ( SecondWord )
+		Write16( RamAddr+2, Words[1] );
+}
+
+void TGameDuino::HideSprite(u8 SpriteIndex,u8 Page)
+{
+	//	gr: don't care about the rest, just Y
+#if SPRITE_FIELD_WRITES
+	SetSpriteFields( SpriteIndex, TSpriteInfo(), TSpriteField::Y, Page );
+#else
+	SetSprite( SpriteIndex, TSpriteInfo(), Page );
+#endif
+}
+
+void TGameDuino::ShowSpritePage(u8 Page)
+{
+	assert( Page < GD_SPRITE_PAGE_COUNT, "Invalid sprite page" );
+	WriteNow( SPR_PAGE, &Page, 1 );
+}
+
+void TGameDuino::BeginSpriteBurst(u8 FirstSpriteIndex,u8 Page)
+{
+	gBurstAddr = GetSpriteRamAddr( FirstSpriteIndex, Page );
+}
+
+void TGameDuino::BurstSprite(const TSpriteInfo& Sprite)
 {
-	//	gr: don't care about the rest, just Y. could make this a GD.wr16()...
-	GD.sprite( SpriteIndex, 0, GD_SPRITE_OFFSCREEN_Y, 0, 0 );
+	//	the queue joins consecutive sprites into one transaction when it flushes
+	u16 Words[2];
+	GetSpriteWords( Sprite, Words[0], Words[1] );
+	u8 Record[GD_SPRITE_RECORD_SIZE] = { lowByte(Words[0]), highByte(Words[0]), lowByte(Words[1]), highByte(Words[1]) };
+	Write( gBurstAddr, Record, sizeof(Record) );
+	gBurstAddr += GD_SPRITE_RECORD_SIZE;
+}
+
+void TGameDuino::BurstHiddenSprite()
+{
+	BurstSprite( TSpriteInfo() );
+}
+
+void TGameDuino::EndSpriteBurst()
+{
+}
+
+void TGameDuino::PutString(u8 x,u8 y,const char* String)
+{
+	u16 Length = min( TGuts::GetStringLength( String ), GD_MAP_WIDTH );
+	gMapShadow.SetCells( x, y, reinterpret_cast<const u8*>( String ), static_cast<u8>( Length ) );
+}
+
+void TGameDuino::Write(u16 Addr,const u8* Data,u16 Size)
+{
+#if VRAM_WRITE_QUEUE
+	gBusStats.mQueuedBytes += Size;
+	if ( gVramQueue.Push( Addr, Data, Size ) )
+		return;
+
+	//	no room, send what we have (early) and try again
+	gBusStats.mOverflowFlushes++;
+	gVramQueue.Flush();
+	if ( gVramQueue.Push( Addr, Data, Size ) )
+		return;
+#endif
+	WriteNow( Addr, Data, Size );
+}
+
+void TGameDuino::Write16(u16 Addr,u16 Value)
+{
+	u8 Bytes[2] = { lowByte(Value), highByte(Value) };
+	Write( Addr, Bytes, sizeof(Bytes) );
+}
+
+void TGameDuino::WriteNow(u16 Addr,const u8* Data,u16 Size)
+{
+	//	anything queued was written first
+	gMapShadow.Flush();
+	gVramQueue.Flush();
+
+	GD.__wstart( Addr );
+	for ( u16 i=0;	i<Size;	i++ )
+		SPI.transfer( Data[i] );
+	GD.__end();
+	OnBusWrite( Size );
+	gMapShadow.OnWriteNow( Addr, Data, Size );
+}
+
+void TGameDuino::WriteNowProgmem(u16 Addr,const prog_uchar* Data,u16 Size)
+{
+	gMapShadow.Flush();
+	gVramQueue.Flush();
+
+	GD.__wstart( Addr );
+	for ( u16 i=0;	i<Size;	i++ )
+		SPI.transfer( pgm_read_byte( &Data[i] ) );
+	GD.__end();
+	OnBusWrite( Size );
+	gMapShadow.OnWriteNowProgmem( Addr, Data, Size );
+}
+
+void TGameDuino::FlushWrites()
+{
+	gMapShadow.Flush();
+	gVramQueue.Flush();
+}
+
+const TGameDuino::TBusStats& TGameDuino::GetBusStats()
+{
+	return gBusStats;
+}
+
+void TGameDuino::ResetBusStats()
+{
+	gBusStats = TBusStats();
+}
+
+void TGameDuino::OnBusWrite(u32 DataBytes)
+{
+	//	GD.copy/wr etc all start with a 2 byte address
+	gBusStats.mTransactions++;
+	gBusStats.mBytes += 2 + DataBytes;
+}
+
+
+bool TVramQueue::Push(u16 Addr,const u8* Data,u16 Size)
+{
+	if ( mWrites.GetSize() >= mWrites.MaxSize() || mData.GetSize() + Size > mData.MaxSize() )
+		return false;
+
+	TVramWrite& NewWrite = mWrites.PushBack();
+	NewWrite.mAddr = Addr;
+	NewWrite.mSize = Size;
+	NewWrite.mDataIndex = mData.GetSize();
+	mData.SetSize( mData.GetSize() + Size );
+	memcpy( &mData[NewWrite.mDataIndex], Data, Size );
+	return true;
+}
+
+void TVramQueue::Flush()
+{
+	//	sort by address, writes to the same address stay in the order they were made
+	//	(they mostly arrive in order already)
+	BufferArray<u16,VRAM_QUEUE_WRITE_COUNT> Order;
+	for ( int w=0;	w<mWrites.GetSize();	w++ )
+	{
+		int i = Order.GetSize();
+		Order.PushBack( w );
+		for ( ;	i>0 && mWrites[Order[i-1]].mAddr > mWrites[w].mAddr;	i-- )
+			Order[i] = Order[i-1];
+		Order[i] = w;
+	}
+
+	for ( int First=0;	First<Order.GetSize();	)
+	{
+		//	everything overlapping or touching goes out in one transaction
+		u16 SpanStart = mWrites[Order[First]].mAddr;
+		u32 SpanEnd = SpanStart + mWrites[Order[First]].mSize;
+		int Last = First;
+		while ( Last+1 < Order.GetSize() && mWrites[Order[Last+1]].mAddr <= SpanEnd )
+		{
+			Last++;
+			auto& Write = mWrites[Order[Last]];
+			SpanEnd = max( SpanEnd, static_cast<u32>( Write.mAddr + Write.mSize ) );
+		}
+
+		GD.__wstart( SpanStart );
+		int Active = First;
+		for ( u32 Addr=SpanStart;	Addr<SpanEnd;	Addr++ )
+		{
+			//	skip writes we're past, then the latest write covering this byte wins
+			while ( mWrites[Order[Active]].mAddr + mWrites[Order[Active]].mSize <= Addr )
+				Active++;
+			int Latest = Order[Active];
+			for ( int w=Active+1;	w<=Last && mWrites[Order[w]].mAddr<=Addr;	w++ )
+			{
+				auto& Write = mWrites[Order[w]];
+				if ( Addr < Write.mAddr + Write.mSize && Order[w] > Latest )
+					Latest = Order[w];
+			}
+			auto& Write = mWrites[Latest];
+			SPI.transfer( mData[ Write.mDataIndex + (Addr - Write.mAddr) ] );
+		}
+		GD.__end();
+		TGameDuino::OnBusWrite( SpanEnd - SpanStart );
+
+		First = Last+1;
+	}
+
+	mWrites.Clear();
+	mData.Clear();
+}
+
+u32 TCachedCharacter::GetHash() const
+{
+	u32 Hash = TGuts::GetHash( mCharacter.mMap.GetRawData(), mCharacter.mMap.GetDataSize() );
+	return TGuts::GetHash( reinterpret_cast<const u8*>( mPalette ), sizeof(mPalette), Hash );
+}
+
+bool TCachedCharacter::operator==(const TCachedCharacter& That) const
+{
+	for ( int i=0;	i<mCharacter.mMap.GetSize();	i++ )
+		if ( mCharacter.mMap[i] != That.mCharacter.mMap[i] )
+			return false;
+	for ( int i=0;	i<4;	i++ )
+		if ( mPalette[i].mRgba != That.mPalette[i].mRgba )
+			return false;
+	return true;
+}
+
+int TCharacterCache::AcquireCharacter(const TCharacter& Character,const BufferArray<TColour16,4>& Palette)
+{
+	TCachedCharacter Cached;
+	Cached.mCharacter = Character;
+	for ( int i=0;	i<Palette.GetSize();	i++ )
+		Cached.mPalette[i] = Palette[i];
+
+	bool Miss = false;
+	int Slot = mSlots.Acquire( Cached, Miss );
+	if ( Slot < 0 || !Miss )
+		return Slot;
+
+	//	upload the character and its colours
+	TGameDuino::Write( RAM_CHR + (Slot * GD_CHAR_DATA_SIZE), Character.mMap.GetRawData(), Character.mMap.GetDataSize() );
+	TGameDuino::Write( RAM_PAL + (Slot * sizeof(Cached.mPalette)), reinterpret_cast<const u8*>( Cached.mPalette ), sizeof(Cached.mPalette) );
+	return Slot;
+}
+
+TSpritePaletteCache::TSpritePaletteCache() :
+	mReleaseCounter	( 0 ),
+	mHits			( 0 ),
+	mMisses			( 0 )
+{
+	mColours.SetSize( mColours.MaxSize() );
+
+	u16 FirstColour = 0;
+	for ( int t=0;	t<TGameDuino::TSpritePal::_Max;	t++ )
+	{
+		auto Type = static_cast<TGameDuino::TSpritePal::Type>( t );
+		u8 BankCount = (Type == TGameDuino::TSpritePal::Pal256) ? 4 : 2;
+		for ( u8 i=0;	i<BankCount;	i++ )
+		{
+			auto& Bank = mBanks.PushBack();
+			Bank.mType = Type;
+			Bank.mIndex = i;
+			Bank.mFirstColour = FirstColour;
+			FirstColour += Bank.GetMaxColourCount();
+		}
+	}
+}
+
+TGameDuino::TSpritePal::Type TSpritePaletteCache::GetPaletteType(u16 ColourCount)
+{
+	if ( ColourCount <= 4 )
+		return TGameDuino::TSpritePal::Pal4;
+	if ( ColourCount <= 16 )
+		return TGameDuino::TSpritePal::Pal16;
+	return TGameDuino::TSpritePal::Pal256;
+}
+
+TColour16 TSpritePaletteCache::ReadColour(const u8* Colours,u16 Index,bool Progmem)
+{
+	TColour16 Colour;
+	if ( Progmem )
+		Colour.mRgba = pgm_read_byte( &Colours[ Index * sizeof(TColour16) ] ) | (pgm_read_byte( &Colours[ (Index * sizeof(TColour16)) + 1 ] ) << 8);
+	else
+		Colour = reinterpret_cast<const TColour16*>( Colours )[Index];
+	return Colour;
+}
+
+int TSpritePaletteCache::AcquirePaletteData(const u8* Colours,u16 ColourCount,bool Progmem)
+{
+	assert( ColourCount > 0 && ColourCount <= 256, "Invalid palette size" );
+	auto Type = GetPaletteType( ColourCount );
+	u32 Hash = TGuts::GetHash( NULL, 0 );
+	for ( u16 c=0;	c<ColourCount;	c++ )
+	{
+		TColour16 Colour = ReadColour( Colours, c, Progmem );
+		Hash = TGuts::GetHash( reinterpret_cast<const u8*>( &Colour.mRgba ), sizeof(Colour.mRgba), Hash );
+	}
+
+	//	look for the same palette, else the empty or longest released bank of the type
+	int Free = -1;
+	for ( int b=0;	b<mBanks.GetSize();	b++ )
+	{
+		auto& Bank = mBanks[b];
+		if ( Bank.mType != Type )
+			continue;
+
+		if ( Bank.mColourCount == ColourCount && Bank.mHash == Hash )
+		{
+			bool Same = true;
+			for ( u16 c=0;	c<ColourCount && Same;	c++ )
+				Same = ( mColours[Bank.mFirstColour+c].mRgba == ReadColour( Colours, c, Progmem ).mRgba );
+			if ( Same )
+			{
+				Bank.mRefCount++;
+				mHits++;
+				return b;
+			}
+		}
+
+		if ( Bank.mRefCount > 0 )
+			continue;
+		if ( Free == -1 || (Bank.mColourCount == 0 && mBanks[Free].mColourCount > 0) )
+			Free = b;
+		else if ( mBanks[Free].mColourCount > 0 && static_cast<u16>( mReleaseCounter - Bank.mReleaseTime ) > static_cast<u16>( mReleaseCounter - mBanks[Free].mReleaseTime ) )
+			Free = b;
+	}
+
+	if ( Free == -1 )
+		return -1;
+
+	//	only the colours that differ from what's there need sending
+	auto& Bank = mBanks[Free];
+	for ( u16 c=0;	c<ColourCount;	c++ )
+	{
+		auto& Colour = mColours[Bank.mFirstColour+c];
+		TColour16 NewColour = ReadColour( Colours, c, Progmem );
+		if ( c >= Bank.mKnownCount || Colour.mRgba != NewColour.mRgba )
+			Bank.mDirty.Add( c );
+		Colour = NewColour;
+	}
+	Bank.mColourCount = ColourCount;
+	Bank.mHash = Hash;
+	Bank.mRefCount = 1;
+	mMisses++;
+	return Free;
+}
+
+void TSpritePaletteCache::ReleasePalette(u8 Bank)
+{
+	assert( mBanks[Bank].mRefCount > 0, "Palette released too many times" );
+	if ( --mBanks[Bank].mRefCount == 0 )
+		mBanks[Bank].mReleaseTime = mReleaseCounter++;
+}
+
+void TSpritePaletteCache::Flush()
+{
+	for ( int b=0;	b<mBanks.GetSize();	b++ )
+	{
+		auto& Bank = mBanks[b];
+		if ( !Bank.mDirty.IsDirty() )
+			continue;
+
+		u16 RamAddr = TGameDuino::GetSpritePaletteRamAddr( Bank.mType, Bank.mIndex );
+		RamAddr += Bank.mDirty.mFirst * sizeof(TColour16);
+		u16 Count = Bank.mDirty.mLast - Bank.mDirty.mFirst + 1;
+		TGameDuino::Write( RamAddr, reinterpret_cast<const u8*>( &mColours[Bank.mFirstColour+Bank.mDirty.mFirst] ), Count * sizeof(TColour16) );
+		if ( Bank.mDirty.mFirst <= Bank.mKnownCount )
+			Bank.mKnownCount = max( Bank.mKnownCount, Bank.mDirty.mLast+1 );
+		Bank.mDirty.Clear();
+	}
+}
+
+u32 TGuts::GetHash(const u8* Data,u16 Size,u32 Hash)
+{
+	for ( u16 i=0;	i<Size;	i++ )
+	{
+		Hash ^= Data[i];
+		Hash *= 16777619u;
+	}
+	return Hash;
+}
+
+u16 TGuts::GetSqrt(u32 Value)
+{
+	//	a bit of the root per iteration, shifts and adds only
+	u32 Root = 0;
+	u32 Bit = 1ul << 30;
+	while ( Bit > Value )
+		Bit >>= 2;
+
+	while ( Bit )
+	{
+		if ( Value >= Root + Bit )
+		{
+			Value -= Root + Bit;
+			Root = (Root >> 1) + Bit;
+		}
+		else
+		{
+			Root >>= 1;
+		}
+		Bit >>= 2;
+	}
+	return static_cast<u16>( Root );
 }
 
 u16 TGuts::GetStringLength(const char* String)
@@ -458,8 +1480,308 @@ void TGuts::Assert(bool Condition,const char* Error,const char* Function)
 	}
 	
 
+#if defined(GD_HEADLESS)
+	THeadless::Abort( Error, Function );
+#endif
+
 	while( true )
 	{
 		delay(1000);
 	}
 }
+
+
+
+TMapScroller::TMapScroller(TWorldMapSource& Source) :
+	mSource		( Source ),
+	mLoaded		( false )
+{
+}
+
+u16 TMapScroller::GetLoadedTarget(u16 ScrollPixel,u16 TileSize,u16 ScreenSize,u16 WorldSize) const
+{
+	//	whole world fits
+	if ( WorldSize <= GD_MAP_WIDTH )
+		return 0;
+
+	//	tiles on screen (+1 for the part-tile at each edge), put the spare ring space either side
+	s32 ScreenTiles = (ScreenSize / TileSize) + 2;
+	s32 Left = (ScrollPixel / TileSize) - ((GD_MAP_WIDTH - ScreenTiles) / 2);
+	return static_cast<u16>( limit( Left, 0, static_cast<s32>( WorldSize - GD_MAP_WIDTH ) ) );
+}
+
+void TMapScroller::SetScroll(const Type2<u16>& Scroll)
+{
+	mScroll = Scroll;
+	Type2<u16> Target( GetLoadedTarget( Scroll.x, GD_CHAR_WIDTH, GD_SCREEN_WIDTH, mSource.GetWidth() ),
+						GetLoadedTarget( Scroll.y, GD_CHAR_HEIGHT, GD_SCREEN_HEIGHT, mSource.GetHeight() ) );
+
+	if ( !mLoaded )
+	{
+		mLoadedTile = Target;
+		LoadAll();
+		mLoaded = true;
+	}
+	else
+	{
+		//	moving the window overwrites the ring column/row on the side we're leaving
+		if ( Target.x > mLoadedTile.x )
+		{
+			LoadColumn( mLoadedTile.x + GD_MAP_WIDTH );
+			mLoadedTile.x++;
+		}
+		else if ( Target.x < mLoadedTile.x )
+		{
+			mLoadedTile.x--;
+			LoadColumn( mLoadedTile.x );
+		}
+
+		if ( Target.y > mLoadedTile.y )
+		{
+			LoadRow( mLoadedTile.y + GD_MAP_HEIGHT );
+			mLoadedTile.y++;
+		}
+		else if ( Target.y < mLoadedTile.y )
+		{
+			mLoadedTile.y--;
+			LoadRow( mLoadedTile.y );
+		}
+	}
+
+	//	hardware scroll wraps at the map size too
+	TGameDuino::SetMapScroll( Type2<u16>( Scroll.x % (GD_MAP_WIDTH*GD_CHAR_WIDTH), Scroll.y % (GD_MAP_HEIGHT*GD_CHAR_HEIGHT) ) );
+}
+
+bool TMapScroller::IsScreenLoaded() const
+{
+	u16 Right = (mScroll.x + GD_SCREEN_WIDTH - 1) / GD_CHAR_WIDTH;
+	u16 Bottom = (mScroll.y + GD_SCREEN_HEIGHT - 1) / GD_CHAR_HEIGHT;
+	return ( mScroll.x / GD_CHAR_WIDTH >= mLoadedTile.x ) && ( Right < mLoadedTile.x + GD_MAP_WIDTH ) &&
+			( mScroll.y / GD_CHAR_HEIGHT >= mLoadedTile.y ) && ( Bottom < mLoadedTile.y + GD_MAP_HEIGHT );
+}
+
+void TMapScroller::LoadAll()
+{
+	u16 Height = min( mSource.GetHeight(), GD_MAP_HEIGHT );
+	for ( u16 r=0;	r<Height;	r++ )
+		LoadRow( mLoadedTile.y + r );
+}
+
+void TMapScroller::LoadColumn(u16 WorldX)
+{
+	if ( WorldX >= mSource.GetWidth() )
+		return;
+
+	u8 x = WorldX % GD_MAP_WIDTH;
+	u16 Height = min( mSource.GetHeight(), GD_MAP_HEIGHT );
+	for ( u16 r=0;	r<Height;	r++ )
+	{
+		u16 WorldY = mLoadedTile.y + r;
+		u8 Tile = mSource.GetTile( WorldX, WorldY );
+		TGameDuino::SetMapCells( x, WorldY % GD_MAP_HEIGHT, &Tile, 1 );
+	}
+}
+
+void TMapScroller::LoadRow(u16 WorldY)
+{
+	if ( WorldY >= mSource.GetHeight() )
+		return;
+
+	//	the row can wrap around the ring, so it goes in up to 2 pieces
+	u8 y = WorldY % GD_MAP_HEIGHT;
+	u16 Width = min( mSource.GetWidth(), GD_MAP_WIDTH );
+	u8 Tiles[GD_MAP_WIDTH];
+	for ( u16 c=0;	c<Width;	)
+	{
+		u16 WorldX = mLoadedTile.x + c;
+		u8 x = WorldX % GD_MAP_WIDTH;
+		u8 Count = min( Width - c, GD_MAP_WIDTH - x );
+		mSource.GetTiles( WorldX, WorldY, Tiles, Count );
+		TGameDuino::SetMapCells( x, y, Tiles, Count );
+		c += Count;
+	}
+}
+
+
+
+TSpriteImageCache::TSpriteImageCache(TSpriteImageSource& Source) :
+	mSource		( Source )
+{
+	mLoadedBytes.SetSize( mLoadedBytes.MaxSize() );
+	mLoadedBytes.SetAll( 0 );
+}
+
+int TSpriteImageCache::AcquireImage(u16 ImageId,bool LoadNow)
+{
+	assert( ImageId < mSource.GetImageCount(), "Sprite image id out of range" );
+	TSpriteImageKey Key;
+	Key.mImageId = ImageId;
+
+	bool Miss = false;
+	int Slot = mSlots.Acquire( Key, Miss );
+	if ( Slot < 0 )
+		return Slot;
+
+	//	new image; if the slot was still loading something else it just starts again
+	if ( Miss )
+	{
+		mLoadedBytes[Slot] = 0;
+		if ( mPending.FindIndex( static_cast<u8>(Slot) ) == -1 )
+			mPending.PushBack( Slot );
+	}
+
+	if ( LoadNow && !IsImageReady( Slot ) )
+	{
+		LoadChunk( Slot, GD_SPRITE_DATA_SIZE - mLoadedBytes[Slot] );
+		RemovePending( mPending.FindIndex( static_cast<u8>(Slot) ) );
+	}
+	return Slot;
+}
+
+void TSpriteImageCache::LoadChunk(u8 Slot,u16 Size)
+{
+	u16 ImageId = mSlots.GetContent( Slot ).mImageId;
+	u8 Data[SPRITE_IMAGE_STREAM_CHUNK];
+	while ( Size > 0 )
+	{
+		u16 Offset = mLoadedBytes[Slot];
+		u16 ChunkSize = min( Size, SPRITE_IMAGE_STREAM_CHUNK );
+		mSource.GetImageData( ImageId, Offset, Data, ChunkSize );
+		TGameDuino::Write( RAM_SPRIMG + (Slot * GD_SPRITE_DATA_SIZE) + Offset, Data, ChunkSize );
+		mLoadedBytes[Slot] += ChunkSize;
+		Size -= ChunkSize;
+	}
+}
+
+void TSpriteImageCache::RemovePending(u16 PendingIndex)
+{
+	for ( int i=PendingIndex;	i<mPending.GetSize()-1;	i++ )
+		mPending[i] = mPending[i+1];
+	mPending.SetSize( mPending.GetSize()-1 );
+}
+
+u16 TSpriteImageCache::StreamImages(u32 DeadlineMicros,u16 MaxBytes)
+{
+	u16 Bytes = 0;
+	while ( !mPending.IsEmpty() && Bytes < MaxBytes && static_cast<s32>( micros() - DeadlineMicros ) < 0 )
+	{
+		u8 Slot = mPending[0];
+		u16 ChunkSize = min( GD_SPRITE_DATA_SIZE - mLoadedBytes[Slot], SPRITE_IMAGE_STREAM_CHUNK );
+		ChunkSize = min( ChunkSize, MaxBytes - Bytes );
+		LoadChunk( Slot, ChunkSize );
+		Bytes += ChunkSize;
+
+		if ( IsImageReady( Slot ) )
+			RemovePending( 0 );
+	}
+	return Bytes;
+}
+
+
+
+TVramDecompressor::TVramDecompressor() :
+	mSrc		( NULL ),
+	mItemsLeft	( 0 ),
+	mCopyLeft	( 0 )
+{
+}
+
+void TVramDecompressor::Begin(const prog_uchar* Src,u16 DestAddr)
+{
+	mSrc = Src;
+	mSrcMask = 0x1;
+	mDestAddr = DestAddr;
+	mWritten = 0;
+	mFlushed = 0;
+	mCopyLeft = 0;
+
+	mOffsetBits = GetBits( 4 );
+	mLengthBits = GetBits( 4 );
+	mMinLength = GetBits( 2 );
+	mItemsLeft = GetBits( 16 );
+	assert( (1u << mOffsetBits) <= GD_DECOMPRESS_WINDOW, "Compressed data reaches back further than GD_DECOMPRESS_WINDOW" );
+}
+
+u16 TVramDecompressor::GetBits(u8 Count)
+{
+	//	fields are most significant bit first, bytes are read from the bottom bit up
+	u16 Bits = 0;
+	while ( Count-- )
+	{
+		Bits <<= 1;
+		if ( pgm_read_byte( mSrc ) & mSrcMask )
+			Bits |= 1;
+		mSrcMask <<= 1;
+		if ( mSrcMask == 0 )
+		{
+			mSrcMask = 0x1;
+			mSrc++;
+		}
+	}
+	return Bits;
+}
+
+u16 TVramDecompressor::Decompress(u16 MaxBytes)
+{
+	//	everything we output has to still be in the ring when we flush
+	MaxBytes = min( MaxBytes, GD_DECOMPRESS_WINDOW );
+	const u16 WindowMask = GD_DECOMPRESS_WINDOW-1;
+
+	u16 Count = 0;
+	while ( Count < MaxBytes && !IsFinished() )
+	{
+		if ( mCopyLeft == 0 )
+		{
+			mItemsLeft--;
+			if ( GetBits( 1 ) == 0 )
+			{
+				mWindow[ mWritten++ & WindowMask ] = static_cast<u8>( GetBits( 8 ) );
+				Count++;
+				continue;
+			}
+			mCopyOffset = GetBits( mOffsetBits ) + 1;
+			mCopyLeft = GetBits( mLengthBits ) + mMinLength;
+		}
+
+		mWindow[ mWritten & WindowMask ] = mWindow[ (mWritten - mCopyOffset) & WindowMask ];
+		mWritten++;
+		mCopyLeft--;
+		Count++;
+	}
+
+	FlushOutput();
+	return Count;
+}
+
+void TVramDecompressor::FlushOutput()
+{
+	//	the ring can wrap, so this is up to 2 writes
+	while ( mFlushed != mWritten )
+	{
+		u16 Start = mFlushed % GD_DECOMPRESS_WINDOW;
+		u16 Size = min( static_cast<u16>( mWritten - mFlushed ), static_cast<u16>( GD_DECOMPRESS_WINDOW - Start ) );
+		TGameDuino::Write( mDestAddr, &mWindow[Start], Size );
+		mDestAddr += Size;
+		mFlushed += Size;
+	}
+}
+
+
+
+TAssetPack::TAssetPack(const prog_uchar* Pack) :
+	mPack	( Pack )
+{
+	assert( pgm_read_byte( &Pack[0] ) == 'A' && pgm_read_byte( &Pack[1] ) == 'P', "Not an asset pack" );
+}
+
+void TAssetPack::Load() const
+{
+	for ( u16 b=0;	b<GetBurstCount();	b++ )
+	{
+		u16 Entry = 4 + (b * 3 * sizeof(u16));
+		u16 Addr = ReadU16( Entry );
+		u16 Size = ReadU16( Entry + 2 );
+		u16 Offset = ReadU16( Entry + 4 );
+		TGameDuino::WriteNowProgmem( Addr, &mPack[Offset], Size );
+	}
+}
@@ -13,6 +13,11 @@
 #define GD_SPRITE_DATA_SIZE	(GD_SPRITE_WIDTH*GD_SPRITE_HEIGHT)
 #define GD_PAL256_SIZE		(2*256)
 #define GD_SPRITE_OFFSCREEN_Y	400
+#define GD_SCREEN_WIDTH		400
+#define GD_SCREEN_HEIGHT	300
+#define GD_SPRITE_RECORD_SIZE	4	//	bytes per sprite in RAM_SPR
+#define GD_SPRITE_PAGE_COUNT	2
+#define GD_SPRITE_PAGE_SIZE		(256*GD_SPRITE_RECORD_SIZE)
 
 
 class TFrameDebug
@@ -22,7 +27,7 @@ public:
 	BufferString<100>&	PushBackString()			{	return mStrings.PushBack();	}
 
 public:
-	BufferArray<BufferString<100>,2>	mStrings;
+	BufferArray<BufferString<100>,8>	mStrings;
 };
 
 
@@ -68,15 +73,17 @@ class TSpriteInfo
 {
 public:
 	TSpriteInfo() :
-		mPosition	( 0, GD_SPRITE_OFFSCREEN_Y ),
 		mImage		( 0 ),
-		mPalette	( 0 )
+		mPalette	( 0 ),
+		mRotation	( 0 ),
+		mPosition	( 0, GD_SPRITE_OFFSCREEN_Y )
 	{
 	}
-	TSpriteInfo(const TPoint& Position,u8 Image,u8 Palette=0) :
-		mPosition	( Position ),
+	TSpriteInfo(const TPoint& Position,u8 Image,u8 Palette=0,u8 Rotation=0) :
 		mImage		( Image ),
-		mPalette	( Palette )
+		mPalette	( Palette ),
+		mRotation	( Rotation ),
+		mPosition	( Position )
 	{
 	}
 
@@ -85,6 +92,7 @@ public:
 public:
 	u8		mImage;		//	character index
 	u8		mPalette;	//	palette for image
+	u8		mRotation;	//	3 bits, as GD.sprite's rot
 	TPoint	mPosition;
 };
 
@@ -94,17 +102,19 @@ class TSpriteRef
 {
 public:
 	TSpriteRef() :
-		mIndex	( -1 )
+		mIndex		( -1 ),
+		mGeneration	( 0 )
 	{
 	}
 
 	bool			IsValid() const		{	return mIndex >= 0;	}
 	u8				GetIndex() const	{	return static_cast<u8>( mIndex );	}
 
-	inline bool		operator==(const TSpriteRef& That) const	{	return (this->mIndex == That.mIndex);	}
+	inline bool		operator==(const TSpriteRef& That) const	{	return (this->mIndex == That.mIndex) && (this->mGeneration == That.mGeneration);	}
 
 public:
 	s16		mIndex;
+	u8		mGeneration;	//	sprite def's generation when this ref was made, stale if they differ
 };
 
 
@@ -123,49 +133,200 @@ public:
 	TSpriteRef	mSpriteRef;		//	which sprite is this
 };
 
+//	parts of a sprite that need writing to hardware
+namespace TSpriteField
+{
+	enum Type
+	{
+		X		= 1<<0,
+		Y		= 1<<1,
+		Image	= 1<<2,
+		Palette	= 1<<3,
+		Slot	= 1<<4,		//	moved hardware sprite, everything needs writing
+		Rotation	= 1<<5,
+
+		All		= X|Y|Image|Palette|Slot|Rotation,
+	};
+};
+
 class TSpriteDef
 {
 public:
 	TSpriteDef() :
-		mDepthIndex	( 0xff )
+		mDepthIndex		( 0xff ),
+		mGeneration		( 0 ),
+		mAllocated		( false ),
+		mDepthOffset	( 0 )
 	{
+		for ( int p=0;	p<GD_SPRITE_PAGE_COUNT;	p++ )
+			mDirtyFields[p] = 0;
 	}
 
+	u16			GetDepth() const	{	return mCache.GetDepth() + mDepthOffset;	}
+
 public:
 	TSpriteInfo	mCache;			//	cached info
 	u8			mDepthIndex;	//	index to spritedepth array
+	u8			mGeneration;	//	bumped every time this def is freed
+	bool		mAllocated;
+	u8			mDirtyFields[GD_SPRITE_PAGE_COUNT];	//	TSpriteField's not yet written to each sprite page
+	s16			mDepthOffset;	//	added to the sprite's depth, so the parts of a metasprite sort as one
+};
+
+
+//	a sprite drawn with several hardware sprites, from a metasprite table. Tables are PROGMEM:
+//		u8 frame count, u16 offset of each frame, then per frame
+//		u8 part count, per part s8 x, s8 y, u8 image, u8 palette
+//	part offsets are from the metasprite's position, and rotate with it, the same as GD.xsprite
+#define METASPRITE_MAX_PARTS	4
+
+class TMetasprite
+{
+public:
+	TMetasprite() :
+		mTable		( NULL ),
+		mFrame		( 0 ),
+		mRotation	( 0 )
+	{
+	}
+
+	bool				IsValid() const		{	return mTable != NULL;	}
+	u8					GetFrameCount() const;
+	u8					GetPartCount(u8 Frame) const;
+	TSpriteInfo			GetPart(u8 Frame,u8 Part) const;	//	at our position & rotation
+
+public:
+	const prog_uchar*	mTable;
+	TPoint				mPosition;
+	u8					mFrame;
+	u8					mRotation;
+	BufferArray<TSpriteRef,METASPRITE_MAX_PARTS>	mParts;	//	enough for the biggest frame, spare parts are hidden
 };
 
 class TSpritePool
 {
 public:
-	TSpritePool(bool DefferedBake);
-	TSpriteRef				AllocSprite(const TSpriteInfo& Info);
+	TSpritePool(bool DefferedBake,bool DoubleBuffered=false);
+	TSpriteRef				AllocSprite(const TSpriteInfo& Info,s16 DepthOffset=0);
 	void					FreeSprite(const TSpriteRef& Sprite);
 	void					MoveSprite(const TSpriteRef& Sprite,const TPoint& Position);
+	void					SetSprite(const TSpriteRef& Sprite,const TSpriteInfo& Info,s16 DepthOffset=0);
 	void					SetSpriteDepth(const TSpriteRef& Sprite,u16 Depth);
 	void					BakeHardwareChanges(TFrameDebug& Debug);
+	void					FlipHardwarePages();	//	call in vblank to show the page we baked into
+
+	TMetasprite				AllocMetasprite(const prog_uchar* Table,const TPoint& Position,u8 Frame=0,u8 Rotation=0);	//	invalid if there aren't enough hardware sprites
+	void					FreeMetasprite(TMetasprite& Metasprite);
+	void					MoveMetasprite(TMetasprite& Metasprite,const TPoint& Position);
+	void					SetMetaspriteFrame(TMetasprite& Metasprite,u8 Frame,u8 Rotation=0);
+
+	bool					IsSpriteAllocated(const TSpriteRef& Sprite) const;
+	u16						GetSpriteCount() const						{	return mDepthInfo.GetSize();	}
+	const TSpriteRef&		GetDepthOrderSprite(u16 DepthIndex) const	{	return mDepthInfo[DepthIndex].mSpriteRef;	}	//	back to front (sorted by sprite y)
 
 private:
 //	u8						GetHardwareSpriteIndex(const TSpriteRef& Sprite)	{	return mSprites[Sprite.mIndex].mHardwareIndex;	}
 //	int						FindSpriteDef(u8 HardwareIndex)						{	return mSprites.FindIndex( HardwareIndex );	}
 //	int						GetSpriteDepthIndex(u8 StartingIndex,u16 Depth);
-	void					OnSpriteChanged(const TSpriteRef& Sprite);
-	u8						AllocSpriteDepth(u16 Depth,const TSpriteRef& SpriteRef,u8 HardwareSprite);
-	void					MoveSpriteDepth(u16 FromIndex,u16 ToIndex,bool ForceHardwareAlignment);
+	void					OnSpriteChanged(const TSpriteRef& Sprite,u8 Fields=TSpriteField::All);
+	void					OnSpriteDepthChanged(const TSpriteRef& Sprite);
+	void					UpdateMetasprite(TMetasprite& Metasprite);
+	void					OnHardwareSpriteFreed(u8 HardwareSprite);
+	u8						AllocSpriteDepth(u16 Depth,const TSpriteRef& SpriteRef);
+	u8						AllocHardwareSprite(u16 DepthIndex);
+	bool					IsHardwareSpriteOrdered(u16 DepthIndex) const;
+	void					MoveSpriteDepth(u16 FromIndex,u16 ToIndex);
+	void					ReorderHardwareSprites();
+	void					RebuildSpriteDepths();
 	void					ShiftSpriteDepthsDown(u16 First,u16 Last);
 	void					ShiftSpriteDepthsUp(u16 First,u16 Last);
 	void					BakeHardwareSprite(const TSpriteRef& Sprite);
 
+#if defined(_DEBUG)
 	void					Debug_VerifySync(bool CheckHardwareOrder=true,bool CheckDepthOrder=true);				//	verify all arrays are sync'd up correctly
+#else
+	void					Debug_VerifySync(bool=true,bool=true)	{}		//	O(n^2), debug builds only
+#endif
 
 public:
 	bool								mDefferedBake;		//	if deffered we update all sprites in one batch
+	bool								mDoubleBuffered;	//	bake into the hidden sprite page and flip at vblank
+	u8									mBackPage;			//	sprite page we're baking into
 	u16									mDebug_ChangeCount;		//	count how many sprite changes we make
-	BufferArray<u8,256>					mFreeSprites;		//	unused hardware sprite indexes
+	u16									mDebug_ReorderWrites;	//	hardware sprites re-assigned by re-ordering
+	u16									mDebug_ReorderSaved;	//	re-assignments saved vs sorting the hardware sprites in place
+	bool								mHardwareOrderDirty;	//	depth order has changed and hardware sprites need re-ordering
+	bool								mDepthOrderDirty;		//	too many depth changes this frame, depth info is unsorted until rebuilt
+	u16									mDepthMoveCount;		//	sprites that changed depth this frame
+	u32									mDebug_IncrementalDepthMoves;	//	depth changes bubbled into place
+	u32									mDebug_DepthRebuilds;	//	depth order rebuilds
+	BufferBits<256>						mFreeSprites;		//	unused hardware sprite indexes
 	BufferArray<TSpriteDepthInfo,256>	mDepthInfo;			//	depth info (sorted by depth)
-	BufferArray<TSpriteDef,256>			mSprites;			//	allocated sprites
-	BufferArray<TSpriteRef,256>			mChangedSprites;	//	sprites that need re-baking
+	BufferArray<TSpriteDef,256>			mSprites;			//	allocated sprites (and freed ones waiting to be re-used)
+	BufferArray<u8,256>					mFreeSpriteDefs;	//	freed mSprites indexes
+	BufferBits<256>						mChangedHardwareSprites;	//	hardware sprites that need re-baking
+	BufferArray<TSpriteRef,256>			mHardwareSpriteRefs;		//	which sprite was last flagged on each hardware sprite
+	BufferBits<256>						mUnflippedHardwareSprites;	//	baked into the back page since the last flip
+	BufferBits<256>						mStaleHardwareSprites;		//	back page is missing the front page's last bake
+};
+
+
+//	vram writes made during the frame, sent in address order when flushed (at vblank). Overlapping
+//	writes are resolved (latest wins) and touching ones go out as one SPI transaction
+#define VRAM_QUEUE_DATA_SIZE	2048
+#define VRAM_QUEUE_WRITE_COUNT	512
+
+class TVramWrite
+{
+public:
+	u16		mAddr;
+	u16		mSize;
+	u16		mDataIndex;		//	into TVramQueue::mData
+};
+
+class TVramQueue
+{
+public:
+	bool		Push(u16 Addr,const u8* Data,u16 Size);	//	false if there's no room left
+	void		Flush();
+
+public:
+	BufferArray<TVramWrite,VRAM_QUEUE_WRITE_COUNT>	mWrites;	//	in the order they were made
+	BufferArray<u8,VRAM_QUEUE_DATA_SIZE>			mData;
+};
+
+
+//	copy of RAM_PIC so map changes only upload what's different. Changes are gathered into one
+//	span per row and queued as vram writes on flush
+class TMapRowSpan
+{
+public:
+	TMapRowSpan()					{	Clear();	}
+
+	bool		IsDirty() const		{	return mFirst <= mLast;	}
+	void		Clear()				{	mFirst = GD_MAP_WIDTH;	mLast = 0;	}
+	void		Add(u8 x)			{	mFirst = min( mFirst, x );	mLast = max( mLast, x );	}
+
+public:
+	u8			mFirst;
+	u8			mLast;
+};
+
+class TMapShadow
+{
+public:
+	TMapShadow();
+
+	void		SetCells(u8 x,u8 y,const u8* Cells,u8 Count);	//	along a row, clipped to the map
+	void		SetRegion(const TBackgroundMap& Map,u8 x,u8 y,u8 Width,u8 Height);
+	void		Flush();
+	void		OnWriteNow(u16 Addr,const u8* Data,u16 Size);	//	written straight to vram, flush first
+	void		OnWriteNowProgmem(u16 Addr,const prog_uchar* Data,u16 Size);
+
+public:
+	TBackgroundMap							mMap;
+	BufferArray<TMapRowSpan,GD_MAP_HEIGHT>	mDirtyRows;
+	BufferBits<GD_MAP_HEIGHT>				mKnownRows;		//	rows we've written all of, so mMap matches the hardware
 };
 
 
@@ -186,16 +347,58 @@ namespace TGameDuino
 	void				SetMapPalette(const BufferArray<TColour16,4>& Palette,u8 FirstColour=0);
 	void				SetMapScroll(const Type2<u16>& Pos);
 	void				SetMap(const TBackgroundMap& Map);
+	void				SetMapRegion(const TBackgroundMap& Map,u8 x,u8 y,u8 Width,u8 Height);
+	void				SetMapCells(u8 x,u8 y,const u8* Cells,u8 Count);	//	along a row
 	template<class ARRAY>	//	Array<TCharacter>
 	void				SetMapCharacters(const ARRAY& Characters,u8 FirstCharacter=0);
 	u16					GetSpritePaletteRamAddr(TSpritePal::Type PalType,u8 PaletteIndex);
 	u8					GetSpritePaletteMaxIndex(TSpritePal::Type PalType);
+	u8					GetSpritePaletteSelect(TSpritePal::Type PalType,u8 PaletteIndex,u8 Part=0);	//	TSpriteInfo::mPalette. Part is the nibble (Pal16) or bit pair (Pal4) of the image to use
 	void				SetSpritePalette(const BufferArray<TColour16,256>& Palette,TSpritePal::Type PalType,u8 PaletteIndex=0);
 	void				SetSpriteCharacter(const TSpriteCharacter& Character,u8 Index);
 	template<class ARRAY>
 	void				SetSpriteCharacters(const ARRAY& Characters,u8 FirstIndex=0);
-	void				SetSprite(u8 SpriteIndex,const TSpriteInfo& Sprite);
-	void				HideSprite(u8 SpriteIndex);
+	void				SetSprite(u8 SpriteIndex,const TSpriteInfo& Sprite,u8 Page=0);
+	void				SetSpriteFields(u8 SpriteIndex,const TSpriteInfo& Sprite,u8 Fields,u8 Page=0);	//	write just the half of the sprite that Fields are in, if we can
+	void				HideSprite(u8 SpriteIndex,u8 Page=0);
+	void				ShowSpritePage(u8 Page);	//	not queued, call after FlushWrites at vblank
+	void				PutString(u8 x,u8 y,const char* String);
+
+	//	write a run of consecutive sprites
+	void				BeginSpriteBurst(u8 FirstSpriteIndex,u8 Page=0);
+	void				BurstSprite(const TSpriteInfo& Sprite);
+	void				BurstHiddenSprite();
+	void				EndSpriteBurst();
+
+	//	all writes go through the vram queue (Data is in ram, not PROGMEM)
+	void				Write(u16 Addr,const u8* Data,u16 Size);
+	void				Write16(u16 Addr,u16 Value);
+	void				WriteNow(u16 Addr,const u8* Data,u16 Size);	//	flushes the map shadow and queue first so writes stay in order
+	void				WriteNowProgmem(u16 Addr,const prog_uchar* Data,u16 Size);
+	void				FlushWrites();
+
+	//	SPI traffic we've generated since the last reset
+	class TBusStats
+	{
+	public:
+		TBusStats() :
+			mTransactions		( 0 ),
+			mBytes				( 0 ),
+			mQueuedBytes		( 0 ),
+			mOverflowFlushes	( 0 )
+		{
+		}
+
+	public:
+		u16		mTransactions;	//	each one costs a chip select and 2 address bytes
+		u32		mBytes;			//	including address bytes
+		u32		mQueuedBytes;	//	bytes we asked to write
+		u16		mOverflowFlushes;	//	queue filled up and was sent before vblank
+	};
+
+	const TBusStats&	GetBusStats();
+	void				ResetBusStats();
+	void				OnBusWrite(u32 DataBytes);	//	one transaction of DataBytes
 };
 
 
@@ -240,6 +443,108 @@ public:
 };
 
 
+//	a map character and the 4 colours it's drawn with, as cached by TCharacterCache
+class TCachedCharacter
+{
+public:
+	u32			GetHash() const;
+	bool		operator==(const TCachedCharacter& That) const;
+
+public:
+	TCharacter	mCharacter;
+	TColour16	mPalette[4];
+};
+
+//	shares the 256 hardware map characters between everything that uses them. Identical characters
+//	(with identical palettes) share a slot, and it's only uploaded if it isn't already there
+class TCharacterCache
+{
+public:
+	int			AcquireCharacter(const TCharacter& Character,const BufferArray<TColour16,4>& Palette);	//	-1 if every slot is in use
+	void		AddRef(u8 Slot)								{	mSlots.AddRef( Slot );	}
+	void		ReleaseCharacter(u8 Slot)					{	mSlots.Release( Slot );	}
+	void		Reserve(u8 FirstSlot,u16 Count)				{	mSlots.Reserve( FirstSlot, Count );	}	//	characters managed elsewhere (eg. GD.ascii)
+
+public:
+	TSlotCache<TCachedCharacter,256>	mSlots;
+};
+
+
+//	sprite palette ram as banks of one palette each: 4 Pal256, 2 Pal16 then 2 Pal4
+#define GD_SPRITE_PALETTE_BANKS			8
+#define GD_SPRITE_PALETTE_COLOURS		((4*256)+(2*16)+(2*4))
+
+class TColourSpan
+{
+public:
+	bool		IsDirty() const		{	return mFirst <= mLast;	}
+	void		Clear()				{	mFirst = 0xffff;	mLast = 0;	}
+	void		Add(u16 c)			{	mFirst = min( mFirst, c );	mLast = max( mLast, c );	}
+
+public:
+	u16			mFirst;
+	u16			mLast;
+};
+
+class TSpritePaletteBank
+{
+public:
+	TSpritePaletteBank() :
+		mRefCount		( 0 ),
+		mColourCount	( 0 ),
+		mHash			( 0 ),
+		mReleaseTime	( 0 ),
+		mKnownCount		( 0 )
+	{
+		mDirty.Clear();
+	}
+
+	u16			GetMaxColourCount() const	{	return TGameDuino::GetSpritePaletteMaxIndex( mType ) + 1;	}
+
+public:
+	TGameDuino::TSpritePal::Type	mType;
+	u8			mIndex;			//	bank of this type
+	u16			mFirstColour;	//	in TSpritePaletteCache::mColours
+	u16			mRefCount;
+	u16			mColourCount;	//	0 if it's not holding a palette
+	u32			mHash;
+	u16			mReleaseTime;	//	when the last reference went, oldest is re-used first
+	u16			mKnownCount;	//	colours we've uploaded, so the hardware matches mColours
+	TColourSpan	mDirty;			//	colours that need uploading
+};
+
+//	shares the sprite palettes. Identical palettes share a bank, and each palette goes in the
+//	smallest bank type that holds its colours (the image data has to be packed to match, see
+//	GetSpritePaletteSelect). Changes are kept in a copy of palette ram and only the colours that
+//	differ are uploaded, one burst per bank, on Flush()
+class TSpritePaletteCache
+{
+public:
+	TSpritePaletteCache();
+
+	static TGameDuino::TSpritePal::Type	GetPaletteType(u16 ColourCount);
+
+	int				AcquirePalette(const TColour16* Colours,u16 ColourCount)		{	return AcquirePaletteData( reinterpret_cast<const u8*>( Colours ), ColourCount, false );	}	//	bank or -1 if every bank of the type is in use
+	int				AcquirePalette(const BufferArray<TColour16,256>& Palette)		{	return AcquirePalette( Palette.GetData(), Palette.GetSize() );	}
+	int				AcquirePaletteProgmem(const prog_uchar* Colours,u16 ColourCount)	{	return AcquirePaletteData( Colours, ColourCount, true );	}	//	little endian TColour16s
+	void			AddRef(u8 Bank)									{	mBanks[Bank].mRefCount++;	}
+	void			ReleasePalette(u8 Bank);
+	u8				GetSpritePaletteSelect(u8 Bank,u8 Part=0) const	{	return TGameDuino::GetSpritePaletteSelect( mBanks[Bank].mType, mBanks[Bank].mIndex, Part );	}
+	void			Flush();	//	queue the changed colours, call before TGameDuino::FlushWrites
+
+private:
+	static TColour16	ReadColour(const u8* Colours,u16 Index,bool Progmem);
+	int				AcquirePaletteData(const u8* Colours,u16 ColourCount,bool Progmem);
+
+public:
+	BufferArray<TSpritePaletteBank,GD_SPRITE_PALETTE_BANKS>	mBanks;
+	BufferArray<TColour16,GD_SPRITE_PALETTE_COLOURS>		mColours;	//	copy of sprite palette ram
+	u16						mReleaseCounter;
+	u16						mHits;
+	u16						mMisses;
+};
+
+
 
 
 
@@ -254,6 +559,196 @@ void TGameDuino::SetMapCharacters(const ARRAY& Characters,u8 FirstCharacter)
 		u16 RamAddr = RAM_CHR;
 		RamAddr += (FirstCharacter+c) * (GD_CHAR_DATA_SIZE);
 		int DataSize = Char.mMap.GetDataSize();
-		GD.copy( RamAddr, const_cast<prog_uchar*>( Char.mMap.GetRawData() ), DataSize );
+		Write( RamAddr, reinterpret_cast<const u8*>( Char.mMap.GetRawData() ), DataSize );
+	}
+}
+
+
+
+//	world map tiles for TMapScroller, can be any size
+class TWorldMapSource
+{
+public:
+	virtual u16		GetWidth() const=0;
+	virtual u16		GetHeight() const=0;
+	virtual u8		GetTile(u16 x,u16 y)=0;
+	virtual void	GetTiles(u16 x,u16 y,u8* Tiles,u8 Count)	//	along a row
+	{
+		for ( u8 i=0;	i<Count;	i++ )
+			Tiles[i] = GetTile( x+i, y );
 	}
-}
\ No newline at end of file
+};
+
+class TWorldMapSource_Progmem : public TWorldMapSource
+{
+public:
+	TWorldMapSource_Progmem(const prog_uchar* Tiles,u16 Width,u16 Height) :
+		mTiles	( Tiles ),
+		mWidth	( Width ),
+		mHeight	( Height )
+	{
+	}
+
+	virtual u16		GetWidth() const			{	return mWidth;	}
+	virtual u16		GetHeight() const			{	return mHeight;	}
+	virtual u8		GetTile(u16 x,u16 y)		{	return pgm_read_byte( &mTiles[ x + (static_cast<u32>(y) * mWidth) ] );	}
+
+public:
+	const prog_uchar*	mTiles;
+	u16					mWidth;
+	u16					mHeight;
+};
+
+//	scrolls over a world map bigger than RAM_PIC by using it as a ring buffer of world tiles.
+//	Whatever the world size, a frame uploads at most one column and one row; the tiles loaded
+//	are kept centred on the screen so quick scrolling has some slack to catch up
+class TMapScroller
+{
+public:
+	TMapScroller(TWorldMapSource& Source);
+
+	void				SetScroll(const Type2<u16>& Scroll);	//	world pixel at the top left of the screen
+	bool				IsScreenLoaded() const;					//	false if we're still catching up
+
+private:
+	u16					GetLoadedTarget(u16 ScrollPixel,u16 TileSize,u16 ScreenSize,u16 WorldSize) const;
+	void				LoadAll();
+	void				LoadColumn(u16 WorldX);
+	void				LoadRow(u16 WorldY);
+
+public:
+	TWorldMapSource&	mSource;
+	bool				mLoaded;
+	Type2<u16>			mLoadedTile;	//	world tile at the top left of what's in RAM_PIC
+	Type2<u16>			mScroll;
+};
+
+
+//	sprite images (GD_SPRITE_DATA_SIZE bytes each) for TSpriteImageCache. A bank can hold far
+//	more images than the 64 hardware slots
+#define GD_SPRITE_IMAGE_COUNT	64
+
+class TSpriteImageSource
+{
+public:
+	virtual u16		GetImageCount() const=0;
+	virtual void	GetImageData(u16 ImageId,u16 Offset,u8* Data,u16 Size)=0;	//	part of an image
+};
+
+class TSpriteImageSource_Progmem : public TSpriteImageSource
+{
+public:
+	TSpriteImageSource_Progmem(const prog_uchar* Images,u16 ImageCount) :
+		mImages		( Images ),
+		mImageCount	( ImageCount )
+	{
+	}
+
+	virtual u16		GetImageCount() const		{	return mImageCount;	}
+	virtual void	GetImageData(u16 ImageId,u16 Offset,u8* Data,u16 Size)
+	{
+		const prog_uchar* Image = &mImages[ (static_cast<u32>(ImageId) * GD_SPRITE_DATA_SIZE) + Offset ];
+		for ( u16 i=0;	i<Size;	i++ )
+			Data[i] = pgm_read_byte( &Image[i] );
+	}
+
+public:
+	const prog_uchar*	mImages;
+	u16					mImageCount;
+};
+
+class TSpriteImageKey
+{
+public:
+	u32			GetHash() const								{	return mImageId;	}
+	bool		operator==(const TSpriteImageKey& That) const	{	return mImageId == That.mImageId;	}
+
+public:
+	u16			mImageId;
+};
+
+//	maps logical image ids onto the 64 RAM_SPRIMG slots as they're needed. Slots are reference
+//	counted and the least recently released is re-used. Misses are loaded a chunk at a time
+//	in StreamImages() with whatever time is left at the end of the frame; don't show a sprite
+//	with the slot until IsImageReady()
+#define SPRITE_IMAGE_STREAM_CHUNK	64	//	bytes read from the source at a time
+
+class TSpriteImageCache
+{
+public:
+	TSpriteImageCache(TSpriteImageSource& Source);
+
+	int					AcquireImage(u16 ImageId,bool LoadNow=false);	//	slot or -1 if every slot is in use. LoadNow loads it all before returning
+	void				AddRef(u8 Slot)						{	mSlots.AddRef( Slot );	}
+	void				ReleaseImage(u8 Slot)				{	mSlots.Release( Slot );	}
+	void				Reserve(u8 FirstSlot,u16 Count)		{	mSlots.Reserve( FirstSlot, Count );	}	//	images managed elsewhere
+	bool				IsImageReady(u8 Slot) const			{	return mLoadedBytes[Slot] == GD_SPRITE_DATA_SIZE;	}
+	u16					GetPendingCount() const				{	return mPending.GetSize();	}
+	u16					StreamImages(u32 DeadlineMicros,u16 MaxBytes);	//	load pending images until the deadline or MaxBytes. Returns bytes written
+
+private:
+	void				LoadChunk(u8 Slot,u16 Size);
+	void				RemovePending(u16 PendingIndex);
+
+public:
+	TSpriteImageSource&									mSource;
+	TSlotCache<TSpriteImageKey,GD_SPRITE_IMAGE_COUNT>	mSlots;
+	BufferArray<u16,GD_SPRITE_IMAGE_COUNT>				mLoadedBytes;	//	how much of each slot's image has been written
+	BufferArray<u8,GD_SPRITE_IMAGE_COUNT>				mPending;		//	slots still loading, oldest first
+};
+
+
+//	inflates GD.uncompress() data (as written by the gameduino asset tools) into vram a piece at a
+//	time, so a big asset can load over several frames. Back references come from a ring of the last
+//	bytes we output instead of reading vram back, and the ring is what gets written out
+#define GD_DECOMPRESS_WINDOW	512		//	furthest back reference we can follow (the tools use 9 bit offsets)
+
+class TVramDecompressor
+{
+public:
+	TVramDecompressor();
+
+	void		Begin(const prog_uchar* Src,u16 DestAddr);
+	bool		IsFinished() const		{	return mItemsLeft == 0 && mCopyLeft == 0;	}
+	u16			Decompress(u16 MaxBytes);	//	output up to MaxBytes more (at most GD_DECOMPRESS_WINDOW), returns how many
+
+private:
+	u16			GetBits(u8 Count);
+	void		FlushOutput();
+
+public:
+	const prog_uchar*	mSrc;
+	u8			mSrcMask;		//	next bit of *mSrc
+	u8			mOffsetBits;
+	u8			mLengthBits;
+	u8			mMinLength;
+	u16			mItemsLeft;		//	literals and back references
+	u16			mCopyLeft;		//	of the back reference we're part way through
+	u16			mCopyOffset;
+	u16			mDestAddr;		//	where the next flushed byte goes
+	u16			mWritten;		//	bytes output, the ring position is this % GD_DECOMPRESS_WINDOW
+	u16			mFlushed;		//	bytes sent to vram
+	u8			mWindow[GD_DECOMPRESS_WINDOW];
+};
+
+
+//	vram contents made by Tools/PackAssets.cpp, already in the layout the gameduino uses so loading
+//	is a copy per burst. Map cells keep the map shadow up to date. The caches don't know what the pack
+//	filled, so it has to be reserved or they'll upload over it: characters with TCharacterCache::Reserve,
+//	sprite images with TSpriteImageCache::Reserve, and sprite palette banks by holding a reference on
+//	them with TSpritePaletteCache::AddRef. Layout, little endian:
+//		'A' 'P', u16 burst count, then per burst u16 vram address, u16 size, u16 offset of its data
+class TAssetPack
+{
+public:
+	TAssetPack(const prog_uchar* Pack);
+
+	u16					GetBurstCount() const			{	return ReadU16( 2 );	}
+	void				Load() const;	//	written straight away, after anything already queued
+
+private:
+	u16					ReadU16(u16 Offset) const		{	return pgm_read_byte( &mPack[Offset] ) | (pgm_read_byte( &mPack[Offset+1] ) << 8);	}
+
+public:
+	const prog_uchar*	mPack;
+};
@@ -27,6 +27,8 @@ typedef int32_t		s32;
 namespace TGuts
 {
 	u16		GetStringLength(const char* String);
+	u32		GetHash(const u8* Data,u16 Size,u32 Hash=2166136261u);	//	FNV-1a, pass the last hash to continue it
+	u16		GetSqrt(u32 Value);		//	integer square root (rounded down), no float involved
 }
 
 namespace TColour
@@ -62,6 +64,70 @@ public:
 	u16		mRgba;	//	bgra
 };
 
+//	signed fixed point with 6 fractional bits (Q10.6 precision). Stored in 32 bits so squared
+//	lengths across the playfield don't overflow; products have to stay under 2^19 (eg. 700x700), so
+//	reject things that are far apart on x or y before squaring. sqrt takes values under 2^20
+#define FIXED_FRACTION_BITS		6
+
+class TFixed
+{
+public:
+	TFixed() :
+		mRaw	( 0 )
+	{
+	}
+	TFixed(int Value) :
+		mRaw	( static_cast<s32>(Value) << FIXED_FRACTION_BITS )
+	{
+	}
+	TFixed(float Value) :
+		mRaw	( static_cast<s32>( Value * (1<<FIXED_FRACTION_BITS) + ((Value < 0.f) ? -0.5f : 0.5f) ) )
+	{
+	}
+
+	static TFixed		FromRaw(s32 Raw)					{	TFixed Value;	Value.mRaw = Raw;	return Value;	}
+
+	int					ToInt() const						{	return (mRaw < 0) ? -(-mRaw >> FIXED_FRACTION_BITS) : (mRaw >> FIXED_FRACTION_BITS);	}	//	truncate towards zero like float does
+	float				ToFloat() const						{	return static_cast<float>( mRaw ) / (1<<FIXED_FRACTION_BITS);	}
+
+	TFixed				operator-() const					{	return FromRaw( -mRaw );	}
+	void				operator+=(const TFixed& Value)		{	mRaw += Value.mRaw;	}
+	void				operator-=(const TFixed& Value)		{	mRaw -= Value.mRaw;	}
+	void				operator*=(const TFixed& Value)		{	*this = *this * Value;	}
+	void				operator/=(const TFixed& Value)		{	*this = *this / Value;	}
+
+	//	friends rather than members so floats and ints convert on either side
+	friend TFixed		operator+(const TFixed& a,const TFixed& b)	{	return FromRaw( a.mRaw + b.mRaw );	}
+	friend TFixed		operator-(const TFixed& a,const TFixed& b)	{	return FromRaw( a.mRaw - b.mRaw );	}
+	friend TFixed		operator*(const TFixed& a,const TFixed& b)	{	return FromRaw( (a.mRaw * b.mRaw + (1<<(FIXED_FRACTION_BITS-1))) >> FIXED_FRACTION_BITS );	}
+	friend TFixed		operator/(const TFixed& a,const TFixed& b)
+	{
+		assert( b.mRaw != 0, "Fixed point divide by zero" );
+		return FromRaw( (b.mRaw == 0) ? 0 : (a.mRaw << FIXED_FRACTION_BITS) / b.mRaw );
+	}
+	friend bool			operator==(const TFixed& a,const TFixed& b)	{	return a.mRaw == b.mRaw;	}
+	friend bool			operator!=(const TFixed& a,const TFixed& b)	{	return a.mRaw != b.mRaw;	}
+	friend bool			operator<(const TFixed& a,const TFixed& b)	{	return a.mRaw < b.mRaw;	}
+	friend bool			operator<=(const TFixed& a,const TFixed& b)	{	return a.mRaw <= b.mRaw;	}
+	friend bool			operator>(const TFixed& a,const TFixed& b)	{	return a.mRaw > b.mRaw;	}
+	friend bool			operator>=(const TFixed& a,const TFixed& b)	{	return a.mRaw >= b.mRaw;	}
+
+	//	sqrt(raw/64)*64 == sqrt(raw*64)
+	friend TFixed		sqrt(const TFixed& Value)					{	return FromRaw( (Value.mRaw <= 0) ? 0 : TGuts::GetSqrt( static_cast<u32>( Value.mRaw ) << FIXED_FRACTION_BITS ) );	}
+
+public:
+	s32		mRaw;
+};
+
+//	conversions for code that's either float or fixed point
+namespace TScalar
+{
+	inline int		ToInt(const float& Value)		{	return static_cast<int>( Value );	}
+	inline int		ToInt(const TFixed& Value)		{	return Value.ToInt();	}
+	inline float	ToFloat(const float& Value)		{	return Value;	}
+	inline float	ToFloat(const TFixed& Value)	{	return Value.ToFloat();	}
+};
+
 //	dumb vector base
 template<typename T>
 class TVector2Base
@@ -90,6 +156,10 @@ public:
 template<typename T>
 class TVector2Trig : public TVector2Base<T>
 {
+public:
+	using TVector2Base<T>::x;
+	using TVector2Base<T>::y;
+
 public:
 	TVector2Trig()
 	{
@@ -102,7 +172,7 @@ public:
 public:
 	T				DotProduct(const TVector2Trig& v) const		{	return (x*v.x) + (y*v.y);	}
 	T				DotProduct() const							{	return (x*x) + (y*y);	}
-	void			Normalise(float NormalLength=1.f)			{	T h = NormalLength/GetLength();	x*=h;	y*=h;	};			//	normalises vector
+	void			Normalise(const T& NormalLength=T(1))		{	T h = NormalLength/GetLength();	x*=h;	y*=h;	};			//	normalises vector
 	//TVector2Trig	Normal(float NormalLength=1.f) const		{	return (*this) * (NormalLength/GetLength());	};	//	returns the normal of thsi vector
 	T				GetLength() const							{	return sqrt( GetLengthSq() );	}
 	T				GetLengthSq() const							{	return DotProduct();	}
@@ -124,9 +194,13 @@ public:
 template<typename T,class VECTORBASE=TVector2Base<T>>
 class Type2 : public VECTORBASE
 {
+public:
+	using VECTORBASE::x;
+	using VECTORBASE::y;
+
 protected:
 	//typedef typename VECTORBASE::TYPE T;
-	typedef typename Type2<T,VECTORBASE> THIS;
+	typedef Type2<T,VECTORBASE> THIS;
 
 public:
 	Type2()
@@ -144,24 +218,26 @@ public:
 	template<class VECTYPE>	THIS	operator-(const VECTYPE& Value) const	{	return THIS( x - Value.x, y - Value.y );	}
 	template<class VECTYPE>	THIS	operator*(const VECTYPE& Value) const	{	return THIS( x * Value.x, y * Value.y );	}
 	template<class VECTYPE>	THIS	operator/(const VECTYPE& Value) const	{	return THIS( x / Value.x, y / Value.y );	}
-	template<>				THIS	operator+(const T& Value) const			{	return THIS( x + Value, y + Value );	}
-	template<>				THIS	operator-(const T& Value) const			{	return THIS( x - Value, y - Value );	}
-	template<>				THIS	operator*(const T& Value) const			{	return THIS( x * Value, y * Value );	}
-	template<>				THIS	operator/(const T& Value) const			{	return THIS( x / Value, y / Value );	}
+	//	scalar overloads (not specialisations, they're not allowed in a class outside of msvc)
+							THIS	operator+(const T& Value) const			{	return THIS( x + Value, y + Value );	}
+							THIS	operator-(const T& Value) const			{	return THIS( x - Value, y - Value );	}
+							THIS	operator*(const T& Value) const			{	return THIS( x * Value, y * Value );	}
+							THIS	operator/(const T& Value) const			{	return THIS( x / Value, y / Value );	}
 	
 	template<class VECTYPE>	void	operator+=(const VECTYPE& Value)	{	x += Value.x;	y += Value.y;	}
 	template<class VECTYPE>	void	operator-=(const VECTYPE& Value)	{	x -= Value.x;	y -= Value.y;	}
 	template<class VECTYPE>	void	operator*=(const VECTYPE& Value)	{	x *= Value.x;	y *= Value.y;	}
 	template<class VECTYPE>	void	operator/=(const VECTYPE& Value)	{	x /= Value.x;	y /= Value.y;	}
-	template<>				void	operator+=(const T& Value)			{	x += Value;		y += Value;	}
-	template<>				void	operator-=(const T& Value)			{	x -= Value;		y -= Value;	}
-	template<>				void	operator*=(const T& Value)			{	x *= Value;		y *= Value;	}
-	template<>				void	operator/=(const T& Value)			{	x /= Value;		y /= Value;	}
+							void	operator+=(const T& Value)			{	x += Value;		y += Value;	}
+							void	operator-=(const T& Value)			{	x -= Value;		y -= Value;	}
+							void	operator*=(const T& Value)			{	x *= Value;		y *= Value;	}
+							void	operator/=(const T& Value)			{	x /= Value;		y /= Value;	}
 };
 
 
 typedef Type2<u16>	TPoint;
 typedef Type2<float,TVector2Trig<float>>	TPointf;
+typedef Type2<TFixed,TVector2Trig<TFixed>>	TPointFixed;
 
 template<typename T,u16 MAXSIZE,u16 BUFFERSIZE=MAXSIZE>
 class BufferArray
@@ -262,6 +338,235 @@ protected:
 };
 
 
+//	fixed set of flags, O(1) to set and walks the set bits in index order
+template<u16 BITCOUNT>
+class BufferBits
+{
+public:
+	BufferBits()
+	{
+		Clear();
+	}
+
+	void		Set(u16 Index)				{	assert( Index < BITCOUNT, "Out of bounds" );	mWords[Index>>5] |= GetBit(Index);	}
+	void		Unset(u16 Index)			{	assert( Index < BITCOUNT, "Out of bounds" );	mWords[Index>>5] &= ~GetBit(Index);	}
+	bool		IsSet(u16 Index) const		{	assert( Index < BITCOUNT, "Out of bounds" );	return (mWords[Index>>5] & GetBit(Index)) != 0;	}
+	u16			MaxSize() const				{	return BITCOUNT;	}
+
+	void		Clear()
+	{
+		for ( int w=0;	w<WORDCOUNT;	w++ )
+			mWords[w] = 0;
+	}
+
+	//	set every bit that's set in That
+	void		Merge(const BufferBits& That)
+	{
+		for ( int w=0;	w<WORDCOUNT;	w++ )
+			mWords[w] |= That.mWords[w];
+	}
+
+	bool		IsEmpty() const
+	{
+		for ( int w=0;	w<WORDCOUNT;	w++ )
+			if ( mWords[w] )
+				return false;
+		return true;
+	}
+
+	u16			GetCount() const
+	{
+		u16 Count = 0;
+		for ( int w=0;	w<WORDCOUNT;	w++ )
+			for ( u32 Word=mWords[w];	Word;	Word &= Word-1 )
+				Count++;
+		return Count;
+	}
+
+	//	first set bit at or after FirstIndex, -1 if none
+	int			FindNext(u16 FirstIndex) const
+	{
+		for ( int w=FirstIndex>>5;	w<WORDCOUNT;	w++ )
+		{
+			u32 Word = mWords[w];
+			//	ignore bits before FirstIndex in the first word
+			if ( w == (FirstIndex>>5) )
+				Word &= ~(GetBit(FirstIndex) - 1);
+			if ( !Word )
+				continue;
+
+			int Index = w << 5;
+			while ( !(Word & 1) )
+			{
+				Word >>= 1;
+				Index++;
+			}
+			return Index;
+		}
+		return -1;
+	}
+
+private:
+	static u32	GetBit(u16 Index)			{	return static_cast<u32>(1) << (Index & 31);	}
+
+private:
+	static const int	WORDCOUNT = (BITCOUNT+31) / 32;
+	u32					mWords[WORDCOUNT];
+};
+
+
+//	reference counted slots found by their content, for hardware memory we want to share and re-use.
+//	Unreferenced slots keep their content (so can be found again) until they're the least recently
+//	released and something else needs the space.
+//	CONTENT needs GetHash() and operator==
+template<class CONTENT,u16 SLOTCOUNT>
+class TSlotCache
+{
+public:
+	TSlotCache() :
+		mHits		( 0 ),
+		mMisses		( 0 ),
+		mEvictions	( 0 ),
+		mLruHead	( INVALID ),
+		mLruTail	( INVALID )
+	{
+		for ( int b=0;	b<SLOTCOUNT;	b++ )
+			mBucketFirst[b] = INVALID;
+		for ( int s=0;	s<SLOTCOUNT;	s++ )
+		{
+			mRefCount[s] = 0;
+			mHasContent[s] = false;
+			mReserved[s] = false;
+			mBucketNext[s] = INVALID;
+			mLruPrev[s] = mLruNext[s] = INVALID;
+			PushLru( s );
+		}
+	}
+
+	//	returns slot (referenced) or -1 if every slot is in use. Miss is set if Content needs uploading
+	int				Acquire(const CONTENT& Content,bool& Miss)
+	{
+		u32 Hash = Content.GetHash();
+		for ( u16 s=mBucketFirst[Hash % SLOTCOUNT];	s!=INVALID;	s=mBucketNext[s] )
+		{
+			if ( mHash[s] != Hash || !(mContent[s] == Content) )
+				continue;
+			if ( mRefCount[s]++ == 0 )
+				RemoveLru( s );
+			mHits++;
+			Miss = false;
+			return s;
+		}
+
+		//	re-use the least recently released slot
+		u16 Slot = mLruHead;
+		if ( Slot == INVALID )
+			return -1;
+		RemoveLru( Slot );
+		if ( mHasContent[Slot] )
+		{
+			RemoveBucket( Slot );
+			mEvictions++;
+		}
+		mContent[Slot] = Content;
+		mHash[Slot] = Hash;
+		mHasContent[Slot] = true;
+		mBucketNext[Slot] = mBucketFirst[Hash % SLOTCOUNT];
+		mBucketFirst[Hash % SLOTCOUNT] = Slot;
+		mRefCount[Slot] = 1;
+		mMisses++;
+		Miss = true;
+		return Slot;
+	}
+
+	void			AddRef(u16 Slot)
+	{
+		assert( Slot < SLOTCOUNT && mRefCount[Slot] > 0, "AddRef on unreferenced slot" );
+		mRefCount[Slot]++;
+	}
+
+	void			Release(u16 Slot)
+	{
+		assert( Slot < SLOTCOUNT && mRefCount[Slot] > 0, "Releasing unreferenced slot" );
+		if ( --mRefCount[Slot] == 0 )
+			PushLru( Slot );
+	}
+
+	//	keep slots out of the cache (eg. used by something else)
+	void			Reserve(u16 FirstSlot,u16 Count)
+	{
+		for ( u16 s=FirstSlot;	s<FirstSlot+Count && s<SLOTCOUNT;	s++ )
+		{
+			assert( mRefCount[s] == 0, "Reserving slot in use" );
+			if ( mReserved[s] )
+				continue;
+			RemoveLru( s );
+			if ( mHasContent[s] )
+				RemoveBucket( s );
+			mHasContent[s] = false;
+			mReserved[s] = true;
+		}
+	}
+
+	u16				GetRefCount(u16 Slot) const		{	return mRefCount[Slot];	}
+	const CONTENT&	GetContent(u16 Slot) const		{	return mContent[Slot];	}
+
+private:
+	static const u16	INVALID = 0xffff;
+
+	void			PushLru(u16 Slot)
+	{
+		mLruPrev[Slot] = mLruTail;
+		mLruNext[Slot] = INVALID;
+		if ( mLruTail != INVALID )
+			mLruNext[mLruTail] = Slot;
+		else
+			mLruHead = Slot;
+		mLruTail = Slot;
+	}
+
+	void			RemoveLru(u16 Slot)
+	{
+		if ( mLruPrev[Slot] != INVALID )
+			mLruNext[ mLruPrev[Slot] ] = mLruNext[Slot];
+		else
+			mLruHead = mLruNext[Slot];
+		if ( mLruNext[Slot] != INVALID )
+			mLruPrev[ mLruNext[Slot] ] = mLruPrev[Slot];
+		else
+			mLruTail = mLruPrev[Slot];
+		mLruPrev[Slot] = mLruNext[Slot] = INVALID;
+	}
+
+	void			RemoveBucket(u16 Slot)
+	{
+		u16* Link = &mBucketFirst[ mHash[Slot] % SLOTCOUNT ];
+		while ( *Link != Slot )
+			Link = &mBucketNext[*Link];
+		*Link = mBucketNext[Slot];
+		mBucketNext[Slot] = INVALID;
+	}
+
+public:
+	u32				mHits;
+	u32				mMisses;
+	u32				mEvictions;		//	misses that replaced old content
+
+private:
+	CONTENT			mContent[SLOTCOUNT];
+	u32				mHash[SLOTCOUNT];
+	u16				mRefCount[SLOTCOUNT];
+	bool			mHasContent[SLOTCOUNT];
+	bool			mReserved[SLOTCOUNT];
+	u16				mBucketFirst[SLOTCOUNT];	//	hash % SLOTCOUNT -> first slot
+	u16				mBucketNext[SLOTCOUNT];
+	u16				mLruPrev[SLOTCOUNT];		//	unreferenced slots, least recently released first
+	u16				mLruNext[SLOTCOUNT];
+	u16				mLruHead;
+	u16				mLruTail;
+};
+
+
 //	really really basic string class for adding integers and has a terminator
 template<u16 MAXSIZE>
 class BufferString : public BufferArray<char,MAXSIZE,MAXSIZE+1>
@@ -269,19 +574,19 @@ class BufferString : public BufferArray<char,MAXSIZE,MAXSIZE+1>
 public:
 	BufferString()
 	{
-		SetBufferAll('\0');
+		this->SetBufferAll('\0');
 	}
 	BufferString(const char* String)
 	{
-		SetBufferAll('\0');
+		this->SetBufferAll('\0');
 		(*this) << String;
 	}
 
 	void			SetLength(u16 StringLength)		
 	{
-		SetSize( StringLength+1 );	
-		GetTail() = '\0';	
-		SetSize( StringLength );	
+		this->SetSize( StringLength+1 );	
+		this->GetTail() = '\0';	
+		this->SetSize( StringLength );	
 	}
 
 	BufferString& operator = (const char* String)
@@ -290,7 +595,7 @@ public:
 		(*this) << String;
 		return *this;
 	}
-	operator		const char*() const		{	return GetData();	}
+	operator		const char*() const		{	return this->GetData();	}
 	BufferString&	operator<<(const char* String);
 	BufferString&	operator<<(int Integer);
 };
@@ -304,7 +609,7 @@ inline BufferString<MAXSIZE>& BufferString<MAXSIZE>::operator<<(const char* Stri
 	
 	while ( *String )
 	{
-		PushBack( *String );
+		this->PushBack( *String );
 		String++;
 	}
 
@@ -316,16 +621,24 @@ template<u16 MAXSIZE>
 inline BufferString<MAXSIZE>& BufferString<MAXSIZE>::operator<<(int Integer)
 {
 	if ( Integer < 0 )
-		PushBack('-');
+	{
+		this->PushBack('-');
+		Integer = -Integer;
+	}
 	
+	//	digits come out lowest first, so write them backwards
+	char Digits[10];
+	int DigitCount = 0;
 	while ( true )
 	{
 		int Tenth = (Integer % 10);
-		PushBack( '0' + Tenth );
+		Digits[DigitCount++] = '0' + Tenth;
 		if ( Integer < 10 )
 			break;
 		Integer /= 10;
 	}
+	while ( DigitCount > 0 )
+		this->PushBack( Digits[--DigitCount] );
 	
 	return *this;
 }
@@ -0,0 +1,66 @@
+//	writes startuptables.h, the palettes and sprite images TGame::Init used to make up at runtime.
+//	Build and run from the repository root with
+//		g++ -std=c++11 -O2 -IHeadless -I. Tools/GenerateStartupTables.cpp Headless/GD.cpp TGuts.cpp -o generate_startup_tables
+//		./generate_startup_tables > startuptables.h
+#include "TGuts.h"
+#include <stdio.h>
+
+#define RAINBOW_PALETTE_COUNT	4
+#define SPHERE_IMAGE_COUNT		4
+#define SPHERE_RADIUS			8.f
+
+namespace
+{
+	u8 Lerp(const u8& From,const u8& To,float Time)
+	{
+		float Fromf = static_cast<float>( From );
+		float Tof = static_cast<float>( To );
+		float Valuef = ((Tof - Fromf) * Time) + Fromf;
+		return static_cast<u8>( Valuef );
+	}
+
+	void PrintTable(const char* Name,const u8* Data,u32 Size)
+	{
+		printf( "static PROGMEM prog_uchar %s[] = {\n", Name );
+		for ( u32 i=0;	i<Size;	i++ )
+			printf( "0x%02x,%s", Data[i], ((i % 16) == 15) ? "\n" : " " );
+		printf( "};\n\n" );
+	}
+}
+
+int main()
+{
+	//	red, green, blue, grey ramps; colour 0 is transparent
+	static TColour16 RainbowPalettes[RAINBOW_PALETTE_COUNT][256];
+	for ( int i=0;	i<256;	i++ )
+	{
+		bool Solid = i>0;
+		u8 Component = 255-i;
+		RainbowPalettes[0][i] = TColour16( Component, 0, 0, Solid );
+		RainbowPalettes[1][i] = TColour16( 0, Component, 0, Solid );
+		RainbowPalettes[2][i] = TColour16( 0, 0, Component, Solid );
+		RainbowPalettes[3][i] = TColour16( Component, Component, Component, Solid );
+	}
+
+	//	a sphere per quarter of the palette
+	static u8 SphereImages[SPHERE_IMAGE_COUNT][GD_SPRITE_DATA_SIZE];
+	for ( int s=0;	s<SPHERE_IMAGE_COUNT;	s++ )
+	{
+		for ( int Pixel=0;	Pixel<GD_SPRITE_DATA_SIZE;	Pixel++ )
+		{
+			int x = Pixel % GD_SPRITE_WIDTH;
+			int y = Pixel / GD_SPRITE_WIDTH;
+			TPointf DistToCenter( x-8, y-8 );
+			bool Transparent = ( DistToCenter.GetLengthSq() >= SPHERE_RADIUS*SPHERE_RADIUS );
+			u8 Colour = Lerp( s*64, (s+1)*64, static_cast<float>(Pixel)/256.f );
+			SphereImages[s][Pixel] = Transparent ? 0 : Colour;
+		}
+	}
+
+	printf( "//\tgenerated by Tools/GenerateStartupTables.cpp, don't edit\n\n" );
+	printf( "#define RAINBOW_PALETTE_COUNT\t%d\n", RAINBOW_PALETTE_COUNT );
+	printf( "#define SPHERE_IMAGE_COUNT\t\t%d\n\n", SPHERE_IMAGE_COUNT );
+	PrintTable( "rainbow_palettes", reinterpret_cast<const u8*>( RainbowPalettes ), sizeof(RainbowPalettes) );
+	PrintTable( "sphere_images", &SphereImages[0][0], sizeof(SphereImages) );
+	return 0;
+}
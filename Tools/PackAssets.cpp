@@ -0,0 +1,378 @@
+//	turns source images into a TAssetPack: map characters, sprite images and palettes already packed
+//	the way the gameduino wants them, so loading is a few straight copies into vram.
+//	Build and run from the repository root with
+//		g++ -std=c++11 -O2 -IHeadless -I. Tools/PackAssets.cpp Headless/GD.cpp TGuts.cpp -o pack_assets
+//		./pack_assets assets.txt asset_pack > assetpack.h
+//
+//	the manifest has one image per line (binary ppm, paths from the current directory)
+//		chr <file> <first character> [<map x> <map y>]
+//			8x8 tiles of up to 4 colours each. Identical tiles share a character, and the image is
+//			laid out in RAM_PIC at map x,y (default 0,0)
+//		spr <file> <first image> <bits per pixel: 8, 4 or 2> <palette bank>
+//			16x16 tiles, left to right then top to bottom. 4 and 2 bit images pack 2 or 4 tiles into
+//			each sprite image (nibble/bit pair N is tile N), use TGameDuino::GetSpritePaletteSelect.
+//			Sheets with the same bits per pixel and bank share one palette
+//	magenta (255,0,255) is transparent. # starts a comment
+#include <vector>
+#include <algorithm>	//	before GD.h, which defines min and max
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "TGuts.h"
+
+namespace
+{
+	class TImage
+	{
+	public:
+		TColour16		GetColour(int x,int y) const
+		{
+			const unsigned char* Rgb = &mRgb[ (y * mWidth + x) * 3 ];
+			bool Transparent = ( Rgb[0] == 255 && Rgb[1] == 0 && Rgb[2] == 255 );
+			return Transparent ? TColour16( 0, 0, 0, false ) : TColour16( Rgb[0], Rgb[1], Rgb[2] );
+		}
+
+	public:
+		int							mWidth;
+		int							mHeight;
+		std::vector<unsigned char>	mRgb;
+	};
+
+	//	a run of vram
+	class TPackWrite
+	{
+	public:
+		bool		operator<(const TPackWrite& That) const	{	return mAddr < That.mAddr;	}
+
+	public:
+		u16					mAddr;
+		std::vector<u8>		mData;
+	};
+
+	class TPackPalette
+	{
+	public:
+		int			GetIndex(const TColour16& Colour,const char* Filename)
+		{
+			for ( size_t i=0;	i<mColours.size();	i++ )
+				if ( mColours[i].mRgba == Colour.mRgba )
+					return static_cast<int>( i );
+			if ( static_cast<int>( mColours.size() ) >= mMaxColours )
+			{
+				fprintf( stderr, "%s: more than %d colours in palette bank\n", Filename, mMaxColours );
+				exit( 1 );
+			}
+			mColours.push_back( Colour );
+			return static_cast<int>( mColours.size() ) - 1;
+		}
+
+	public:
+		TGameDuino::TSpritePal::Type	mType;
+		u8								mBank;
+		int								mMaxColours;
+		std::vector<TColour16>			mColours;
+	};
+
+	class TPackCharacter
+	{
+	public:
+		bool		operator==(const TPackCharacter& That) const
+		{
+			return memcmp( mPixels, That.mPixels, sizeof(mPixels) ) == 0 && memcmp( mPalette, That.mPalette, sizeof(mPalette) ) == 0;
+		}
+
+	public:
+		u8			mPixels[GD_CHAR_DATA_SIZE];
+		u16			mPalette[4];
+	};
+
+	std::vector<TPackWrite>		gWrites;
+	std::vector<TPackPalette>	gPalettes;
+	u8							gSpriteImages[GD_SPRITE_IMAGE_COUNT][GD_SPRITE_DATA_SIZE];
+	int							gSpriteImageBpp[GD_SPRITE_IMAGE_COUNT];		//	0 if unused
+	int							gCharacterCount = 0;
+	int							gCharacterTiles = 0;
+
+	TImage LoadPpm(const char* Filename)
+	{
+		FILE* File = fopen( Filename, "rb" );
+		if ( !File )
+		{
+			fprintf( stderr, "%s: can't open\n", Filename );
+			exit( 1 );
+		}
+
+		//	header is P6, width, height, maxval with optional comments between
+		int Values[3];
+		char Magic[3] = { 0 };
+		bool Valid = ( fread( Magic, 1, 2, File ) == 2 && strcmp( Magic, "P6" ) == 0 );
+		for ( int v=0;	Valid && v<3;	v++ )
+		{
+			int c = fgetc( File );
+			while ( c == '#' || c == ' ' || c == '\t' || c == '\r' || c == '\n' )
+			{
+				if ( c == '#' )
+					while ( c != '\n' && c != EOF )
+						c = fgetc( File );
+				c = fgetc( File );
+			}
+			ungetc( c, File );
+			Valid = ( fscanf( File, "%d", &Values[v] ) == 1 );
+		}
+		fgetc( File );
+
+		TImage Image;
+		Image.mWidth = Values[0];
+		Image.mHeight = Values[1];
+		Valid = Valid && Values[2] == 255;
+		if ( Valid )
+		{
+			Image.mRgb.resize( Image.mWidth * Image.mHeight * 3 );
+			Valid = ( fread( &Image.mRgb[0], 1, Image.mRgb.size(), File ) == Image.mRgb.size() );
+		}
+		fclose( File );
+
+		if ( !Valid )
+		{
+			fprintf( stderr, "%s: not an 8 bit binary ppm\n", Filename );
+			exit( 1 );
+		}
+		return Image;
+	}
+
+	void AddWrite(u16 Addr,const u8* Data,size_t Size)
+	{
+		TPackWrite Write;
+		Write.mAddr = Addr;
+		Write.mData.assign( Data, Data + Size );
+		gWrites.push_back( Write );
+	}
+
+	void PackCharacters(const char* Filename,int FirstCharacter,int MapX,int MapY)
+	{
+		TImage Image = LoadPpm( Filename );
+		int Columns = Image.mWidth / GD_CHAR_WIDTH;
+		int Rows = Image.mHeight / GD_CHAR_HEIGHT;
+
+		std::vector<TPackCharacter> Characters;
+		std::vector<u8> Map( Columns * Rows );
+		for ( int r=0;	r<Rows;	r++ )
+		{
+			for ( int c=0;	c<Columns;	c++ )
+			{
+				TPackCharacter Character;
+				memset( &Character, 0, sizeof(Character) );
+				int ColourCount = 0;
+				for ( int y=0;	y<GD_CHAR_HEIGHT;	y++ )
+				{
+					for ( int x=0;	x<GD_CHAR_WIDTH;	x++ )
+					{
+						TColour16 Colour = Image.GetColour( c*GD_CHAR_WIDTH + x, r*GD_CHAR_HEIGHT + y );
+						int Index = 0;
+						while ( Index < ColourCount && Character.mPalette[Index] != Colour.mRgba )
+							Index++;
+						if ( Index == ColourCount )
+						{
+							if ( ColourCount == 4 )
+							{
+								fprintf( stderr, "%s: character at %d,%d has more than 4 colours\n", Filename, c*GD_CHAR_WIDTH, r*GD_CHAR_HEIGHT );
+								exit( 1 );
+							}
+							Character.mPalette[ColourCount++] = Colour.mRgba;
+						}
+
+						//	same layout as TCharacter::Set
+						Character.mPixels[ (x / 4) + (y * 2) ] |= Index << ((3 - (x % 4)) * 2);
+					}
+				}
+
+				std::vector<TPackCharacter>::iterator Existing = std::find( Characters.begin(), Characters.end(), Character );
+				if ( Existing == Characters.end() )
+				{
+					Characters.push_back( Character );
+					Existing = Characters.end() - 1;
+				}
+				Map[ r * Columns + c ] = FirstCharacter + static_cast<int>( Existing - Characters.begin() );
+			}
+		}
+
+		if ( FirstCharacter + Characters.size() > 256 )
+		{
+			fprintf( stderr, "%s: %d characters don't fit after character %d\n", Filename, static_cast<int>( Characters.size() ), FirstCharacter );
+			exit( 1 );
+		}
+
+		for ( size_t i=0;	i<Characters.size();	i++ )
+		{
+			AddWrite( RAM_CHR + ((FirstCharacter + i) * GD_CHAR_DATA_SIZE), Characters[i].mPixels, sizeof(Characters[i].mPixels) );
+			AddWrite( RAM_PAL + ((FirstCharacter + i) * sizeof(Characters[i].mPalette)), reinterpret_cast<const u8*>( Characters[i].mPalette ), sizeof(Characters[i].mPalette) );
+		}
+
+		//	clip the map to RAM_PIC
+		for ( int r=0;	r<Rows && MapY+r<GD_MAP_HEIGHT;	r++ )
+		{
+			int Width = min( Columns, GD_MAP_WIDTH - MapX );
+			if ( Width > 0 )
+				AddWrite( RAM_PIC + ((MapY + r) * GD_MAP_WIDTH) + MapX, &Map[ r * Columns ], Width );
+		}
+
+		gCharacterCount += static_cast<int>( Characters.size() );
+		gCharacterTiles += Columns * Rows;
+	}
+
+	TPackPalette& GetPalette(int Bpp,int Bank,const char* Filename)
+	{
+		TGameDuino::TSpritePal::Type Type = (Bpp == 8) ? TGameDuino::TSpritePal::Pal256 : (Bpp == 4) ? TGameDuino::TSpritePal::Pal16 : TGameDuino::TSpritePal::Pal4;
+		int BankCount = (Type == TGameDuino::TSpritePal::Pal256) ? 4 : 2;
+		if ( Bank < 0 || Bank >= BankCount )
+		{
+			fprintf( stderr, "%s: there's no palette bank %d for %d bit sprites\n", Filename, Bank, Bpp );
+			exit( 1 );
+		}
+
+		for ( size_t p=0;	p<gPalettes.size();	p++ )
+			if ( gPalettes[p].mType == Type && gPalettes[p].mBank == Bank )
+				return gPalettes[p];
+
+		TPackPalette Palette;
+		Palette.mType = Type;
+		Palette.mBank = Bank;
+		Palette.mMaxColours = 1 << Bpp;
+		gPalettes.push_back( Palette );
+		return gPalettes.back();
+	}
+
+	void PackSprites(const char* Filename,int FirstImage,int Bpp,int Bank)
+	{
+		if ( Bpp != 8 && Bpp != 4 && Bpp != 2 )
+		{
+			fprintf( stderr, "%s: sprites are 8, 4 or 2 bits per pixel\n", Filename );
+			exit( 1 );
+		}
+
+		TImage Image = LoadPpm( Filename );
+		TPackPalette& Palette = GetPalette( Bpp, Bank, Filename );
+		int TilesPerImage = 8 / Bpp;
+		int Columns = Image.mWidth / GD_SPRITE_WIDTH;
+		int Rows = Image.mHeight / GD_SPRITE_HEIGHT;
+
+		for ( int t=0;	t<Columns*Rows;	t++ )
+		{
+			int ImageIndex = FirstImage + (t / TilesPerImage);
+			int Part = t % TilesPerImage;
+			if ( ImageIndex >= GD_SPRITE_IMAGE_COUNT || (gSpriteImageBpp[ImageIndex] != 0 && gSpriteImageBpp[ImageIndex] != Bpp) )
+			{
+				fprintf( stderr, "%s: tile %d can't go in sprite image %d\n", Filename, t, ImageIndex );
+				exit( 1 );
+			}
+			gSpriteImageBpp[ImageIndex] = Bpp;
+
+			int TileX = (t % Columns) * GD_SPRITE_WIDTH;
+			int TileY = (t / Columns) * GD_SPRITE_HEIGHT;
+			for ( int p=0;	p<GD_SPRITE_DATA_SIZE;	p++ )
+			{
+				int Index = Palette.GetIndex( Image.GetColour( TileX + (p % GD_SPRITE_WIDTH), TileY + (p / GD_SPRITE_WIDTH) ), Filename );
+				gSpriteImages[ImageIndex][p] |= Index << (Part * Bpp);
+			}
+		}
+	}
+
+	void PrintTable(const char* Name,const std::vector<u8>& Data)
+	{
+		printf( "static PROGMEM prog_uchar %s[] = {\n", Name );
+		for ( size_t i=0;	i<Data.size();	i++ )
+			printf( "0x%02x,%s", Data[i], ((i % 16) == 15) ? "\n" : " " );
+		printf( "};\n" );
+	}
+
+	void PushU16(std::vector<u8>& Data,u16 Value)
+	{
+		Data.push_back( lowByte( Value ) );
+		Data.push_back( highByte( Value ) );
+	}
+}
+
+int main(int argc,char* argv[])
+{
+	if ( argc < 3 )
+	{
+		fprintf( stderr, "usage: pack_assets <manifest> <table name>\n" );
+		return 1;
+	}
+
+	FILE* Manifest = fopen( argv[1], "r" );
+	if ( !Manifest )
+	{
+		fprintf( stderr, "%s: can't open\n", argv[1] );
+		return 1;
+	}
+
+	char Line[1024];
+	while ( fgets( Line, sizeof(Line), Manifest ) )
+	{
+		char* Comment = strchr( Line, '#' );
+		if ( Comment )
+			*Comment = 0;
+
+		char Type[16];
+		char Filename[512];
+		int Args[4] = { 0, 0, 0, 0 };
+		int Count = sscanf( Line, "%15s %511s %d %d %d", Type, Filename, &Args[0], &Args[1], &Args[2] );
+		if ( Count <= 0 )
+			continue;
+
+		if ( strcmp( Type, "chr" ) == 0 && Count >= 3 )
+			PackCharacters( Filename, Args[0], Args[1], Args[2] );
+		else if ( strcmp( Type, "spr" ) == 0 && Count == 5 )
+			PackSprites( Filename, Args[0], Args[1], Args[2] );
+		else
+		{
+			fprintf( stderr, "%s: can't read line: %s", argv[1], Line );
+			return 1;
+		}
+	}
+	fclose( Manifest );
+
+	for ( int i=0;	i<GD_SPRITE_IMAGE_COUNT;	i++ )
+		if ( gSpriteImageBpp[i] )
+			AddWrite( RAM_SPRIMG + (i * GD_SPRITE_DATA_SIZE), gSpriteImages[i], GD_SPRITE_DATA_SIZE );
+	for ( size_t p=0;	p<gPalettes.size();	p++ )
+		AddWrite( TGameDuino::GetSpritePaletteRamAddr( gPalettes[p].mType, gPalettes[p].mBank ), reinterpret_cast<const u8*>( &gPalettes[p].mColours[0] ), gPalettes[p].mColours.size() * sizeof(TColour16) );
+
+	//	join up writes that touch so they go out as one burst
+	std::stable_sort( gWrites.begin(), gWrites.end() );
+	std::vector<TPackWrite> Bursts;
+	for ( size_t w=0;	w<gWrites.size();	w++ )
+	{
+		if ( !Bursts.empty() && Bursts.back().mAddr + Bursts.back().mData.size() > gWrites[w].mAddr )
+		{
+			fprintf( stderr, "assets overlap at vram 0x%04x\n", gWrites[w].mAddr );
+			return 1;
+		}
+		if ( !Bursts.empty() && Bursts.back().mAddr + Bursts.back().mData.size() == gWrites[w].mAddr )
+			Bursts.back().mData.insert( Bursts.back().mData.end(), gWrites[w].mData.begin(), gWrites[w].mData.end() );
+		else
+			Bursts.push_back( gWrites[w] );
+	}
+
+	//	see TAssetPack for the layout
+	std::vector<u8> Pack;
+	Pack.push_back( 'A' );
+	Pack.push_back( 'P' );
+	PushU16( Pack, static_cast<u16>( Bursts.size() ) );
+	size_t DataOffset = Pack.size() + (Bursts.size() * 3 * sizeof(u16));
+	for ( size_t b=0;	b<Bursts.size();	b++ )
+	{
+		PushU16( Pack, Bursts[b].mAddr );
+		PushU16( Pack, static_cast<u16>( Bursts[b].mData.size() ) );
+		PushU16( Pack, static_cast<u16>( DataOffset ) );
+		DataOffset += Bursts[b].mData.size();
+	}
+	for ( size_t b=0;	b<Bursts.size();	b++ )
+		Pack.insert( Pack.end(), Bursts[b].mData.begin(), Bursts[b].mData.end() );
+
+	printf( "//\tgenerated by Tools/PackAssets.cpp from %s, don't edit\n\n", argv[1] );
+	PrintTable( argv[2], Pack );
+	fprintf( stderr, "%d characters from %d tiles, %d palettes, %d bursts, %d bytes\n", gCharacterCount, gCharacterTiles, static_cast<int>( gPalettes.size() ), static_cast<int>( Bursts.size() ), static_cast<int>( Pack.size() ) );
+	return 0;
+}
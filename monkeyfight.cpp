@@ -25,6 +25,7 @@ void loop()
 
 	//	render
     GD.waitvblank();
+	Game.OnVBlank();
 
 	//	system update (GD pull)
 }
@@ -554,124 +554,34 @@ static PROGMEM prog_uchar palette16a[] = {
 0x40,  0x75,  0x00,  0x71,  0xc0,  0x6c,  0x80,  0x64,  0x40,  0x60,  0x00,  0x54,  0x00,  0x00,  0x00,  0x80, 
 };
 #define EXPLODE32_FRAMES 12
-static void draw_explode32(int x, int y, byte anim, byte rot, byte jk = 0)
-{
-  switch (anim) {
-    
-case 0:
-GD.xsprite(x, y, -16, -16, 0, 4, rot, jk);
-GD.xsprite(x, y, 0, -16, 0, 6, rot, jk);
-GD.xsprite(x, y, -16, 0, 1, 4, rot, jk);
-GD.xsprite(x, y, 0, 0, 1, 6, rot, jk);
-break;
-case 1:
-GD.xsprite(x, y, -16, -16, 2, 4, rot, jk);
-GD.xsprite(x, y, 0, -16, 2, 6, rot, jk);
-GD.xsprite(x, y, -16, 0, 3, 4, rot, jk);
-GD.xsprite(x, y, 0, 0, 3, 6, rot, jk);
-break;
-case 2:
-GD.xsprite(x, y, -16, -16, 4, 4, rot, jk);
-GD.xsprite(x, y, 0, -16, 4, 6, rot, jk);
-GD.xsprite(x, y, -16, 0, 5, 4, rot, jk);
-GD.xsprite(x, y, 0, 0, 5, 6, rot, jk);
-break;
-case 3:
-GD.xsprite(x, y, -16, -16, 6, 4, rot, jk);
-GD.xsprite(x, y, 0, -16, 6, 6, rot, jk);
-GD.xsprite(x, y, -16, 0, 7, 4, rot, jk);
-GD.xsprite(x, y, 0, 0, 7, 6, rot, jk);
-break;
-case 4:
-GD.xsprite(x, y, -16, -16, 8, 4, rot, jk);
-GD.xsprite(x, y, 0, -16, 8, 6, rot, jk);
-GD.xsprite(x, y, -16, 0, 9, 4, rot, jk);
-GD.xsprite(x, y, 0, 0, 9, 6, rot, jk);
-break;
-case 5:
-GD.xsprite(x, y, -16, -16, 10, 4, rot, jk);
-GD.xsprite(x, y, 0, -16, 10, 6, rot, jk);
-GD.xsprite(x, y, -16, 0, 11, 4, rot, jk);
-GD.xsprite(x, y, 0, 0, 11, 6, rot, jk);
-break;
-case 6:
-GD.xsprite(x, y, -16, -16, 12, 4, rot, jk);
-GD.xsprite(x, y, 0, -16, 12, 6, rot, jk);
-GD.xsprite(x, y, -16, 0, 13, 4, rot, jk);
-GD.xsprite(x, y, 0, 0, 13, 6, rot, jk);
-break;
-case 7:
-GD.xsprite(x, y, -16, -16, 14, 4, rot, jk);
-GD.xsprite(x, y, 0, -16, 14, 6, rot, jk);
-GD.xsprite(x, y, -16, 0, 15, 4, rot, jk);
-GD.xsprite(x, y, 0, 0, 15, 6, rot, jk);
-break;
-case 8:
-GD.xsprite(x, y, -16, -16, 16, 4, rot, jk);
-GD.xsprite(x, y, 0, -16, 16, 6, rot, jk);
-GD.xsprite(x, y, -16, 0, 17, 4, rot, jk);
-GD.xsprite(x, y, 0, 0, 17, 6, rot, jk);
-break;
-case 9:
-GD.xsprite(x, y, -16, -16, 18, 4, rot, jk);
-GD.xsprite(x, y, 0, -16, 18, 6, rot, jk);
-GD.xsprite(x, y, -16, 0, 19, 4, rot, jk);
-GD.xsprite(x, y, 0, 0, 19, 6, rot, jk);
-break;
-case 10:
-GD.xsprite(x, y, -16, -16, 20, 4, rot, jk);
-GD.xsprite(x, y, 0, -16, 20, 6, rot, jk);
-GD.xsprite(x, y, -16, 0, 21, 4, rot, jk);
-GD.xsprite(x, y, 0, 0, 21, 6, rot, jk);
-break;
-case 11:
-GD.xsprite(x, y, -16, -16, 22, 4, rot, jk);
-GD.xsprite(x, y, 0, -16, 22, 6, rot, jk);
-GD.xsprite(x, y, -16, 0, 23, 4, rot, jk);
-GD.xsprite(x, y, 0, 0, 23, 6, rot, jk);
-break;
-
-    }
-}
+static PROGMEM prog_uchar explode32_metasprite[] = {
+
+0x0c,  0x19,  0x00,  0x2a,  0x00,  0x3b,  0x00,  0x4c,  0x00,  0x5d,  0x00,  0x6e,  0x00,  0x7f,  0x00,  0x90, 
+0x00,  0xa1,  0x00,  0xb2,  0x00,  0xc3,  0x00,  0xd4,  0x00,  0x04,  0xf0,  0xf0,  0x00,  0x04,  0x00,  0xf0, 
+0x00,  0x06,  0xf0,  0x00,  0x01,  0x04,  0x00,  0x00,  0x01,  0x06,  0x04,  0xf0,  0xf0,  0x02,  0x04,  0x00, 
+0xf0,  0x02,  0x06,  0xf0,  0x00,  0x03,  0x04,  0x00,  0x00,  0x03,  0x06,  0x04,  0xf0,  0xf0,  0x04,  0x04, 
+0x00,  0xf0,  0x04,  0x06,  0xf0,  0x00,  0x05,  0x04,  0x00,  0x00,  0x05,  0x06,  0x04,  0xf0,  0xf0,  0x06, 
+0x04,  0x00,  0xf0,  0x06,  0x06,  0xf0,  0x00,  0x07,  0x04,  0x00,  0x00,  0x07,  0x06,  0x04,  0xf0,  0xf0, 
+0x08,  0x04,  0x00,  0xf0,  0x08,  0x06,  0xf0,  0x00,  0x09,  0x04,  0x00,  0x00,  0x09,  0x06,  0x04,  0xf0, 
+0xf0,  0x0a,  0x04,  0x00,  0xf0,  0x0a,  0x06,  0xf0,  0x00,  0x0b,  0x04,  0x00,  0x00,  0x0b,  0x06,  0x04, 
+0xf0,  0xf0,  0x0c,  0x04,  0x00,  0xf0,  0x0c,  0x06,  0xf0,  0x00,  0x0d,  0x04,  0x00,  0x00,  0x0d,  0x06, 
+0x04,  0xf0,  0xf0,  0x0e,  0x04,  0x00,  0xf0,  0x0e,  0x06,  0xf0,  0x00,  0x0f,  0x04,  0x00,  0x00,  0x0f, 
+0x06,  0x04,  0xf0,  0xf0,  0x10,  0x04,  0x00,  0xf0,  0x10,  0x06,  0xf0,  0x00,  0x11,  0x04,  0x00,  0x00, 
+0x11,  0x06,  0x04,  0xf0,  0xf0,  0x12,  0x04,  0x00,  0xf0,  0x12,  0x06,  0xf0,  0x00,  0x13,  0x04,  0x00, 
+0x00,  0x13,  0x06,  0x04,  0xf0,  0xf0,  0x14,  0x04,  0x00,  0xf0,  0x14,  0x06,  0xf0,  0x00,  0x15,  0x04, 
+0x00,  0x00,  0x15,  0x06,  0x04,  0xf0,  0xf0,  0x16,  0x04,  0x00,  0xf0,  0x16,  0x06,  0xf0,  0x00,  0x17, 
+0x04,  0x00,  0x00,  0x17,  0x06, 
+};
 
 #define EXPLODE16_FRAMES 10
-static void draw_explode16(int x, int y, byte anim, byte rot, byte jk = 0)
-{
-  switch (anim) {
-    
-case 0:
-GD.xsprite(x, y, -8, -8, 24, 4, rot, jk);
-break;
-case 1:
-GD.xsprite(x, y, -8, -8, 24, 6, rot, jk);
-break;
-case 2:
-GD.xsprite(x, y, -8, -8, 25, 4, rot, jk);
-break;
-case 3:
-GD.xsprite(x, y, -8, -8, 25, 6, rot, jk);
-break;
-case 4:
-GD.xsprite(x, y, -8, -8, 26, 4, rot, jk);
-break;
-case 5:
-GD.xsprite(x, y, -8, -8, 26, 6, rot, jk);
-break;
-case 6:
-GD.xsprite(x, y, -8, -8, 27, 4, rot, jk);
-break;
-case 7:
-GD.xsprite(x, y, -8, -8, 27, 6, rot, jk);
-break;
-case 8:
-GD.xsprite(x, y, -8, -8, 28, 4, rot, jk);
-break;
-case 9:
-GD.xsprite(x, y, -8, -8, 28, 6, rot, jk);
-break;
-
-    }
-}
+static PROGMEM prog_uchar explode16_metasprite[] = {
+
+0x0a,  0x15,  0x00,  0x1a,  0x00,  0x1f,  0x00,  0x24,  0x00,  0x29,  0x00,  0x2e,  0x00,  0x33,  0x00,  0x38, 
+0x00,  0x3d,  0x00,  0x42,  0x00,  0x01,  0xf8,  0xf8,  0x18,  0x04,  0x01,  0xf8,  0xf8,  0x18,  0x06,  0x01, 
+0xf8,  0xf8,  0x19,  0x04,  0x01,  0xf8,  0xf8,  0x19,  0x06,  0x01,  0xf8,  0xf8,  0x1a,  0x04,  0x01,  0xf8, 
+0xf8,  0x1a,  0x06,  0x01,  0xf8,  0xf8,  0x1b,  0x04,  0x01,  0xf8,  0xf8,  0x1b,  0x06,  0x01,  0xf8,  0xf8, 
+0x1c,  0x04,  0x01,  0xf8,  0xf8,  0x1c,  0x06, 
+};
 
 static PROGMEM prog_uchar palette16b[] = {
 
@@ -679,83 +589,32 @@ static PROGMEM prog_uchar palette16b[] = {
 0x99,  0x3a,  0x58,  0x36,  0x35,  0x32,  0xf3,  0x29,  0x90,  0x21,  0x4d,  0x19,  0xe9,  0x10,  0x00,  0x80, 
 };
 #define ROCK0R_FRAMES 4
-static void draw_rock0r(int x, int y, byte anim, byte rot, byte jk = 0)
-{
-  switch (anim) {
-    
-case 0:
-GD.xsprite(x, y, -8, -8, 29, 5, rot, jk);
-break;
-case 1:
-GD.xsprite(x, y, -8, -8, 29, 7, rot, jk);
-break;
-case 2:
-GD.xsprite(x, y, -8, -8, 30, 5, rot, jk);
-break;
-case 3:
-GD.xsprite(x, y, -8, -8, 30, 7, rot, jk);
-break;
-
-    }
-}
+static PROGMEM prog_uchar rock0r_metasprite[] = {
+
+0x04,  0x09,  0x00,  0x0e,  0x00,  0x13,  0x00,  0x18,  0x00,  0x01,  0xf8,  0xf8,  0x1d,  0x05,  0x01,  0xf8, 
+0xf8,  0x1d,  0x07,  0x01,  0xf8,  0xf8,  0x1e,  0x05,  0x01,  0xf8,  0xf8,  0x1e,  0x07, 
+};
 
 #define ROCK1R_FRAMES 4
-static void draw_rock1r(int x, int y, byte anim, byte rot, byte jk = 0)
-{
-  switch (anim) {
-    
-case 0:
-GD.xsprite(x, y, -16, -16, 31, 5, rot, jk);
-GD.xsprite(x, y, 0, -16, 31, 7, rot, jk);
-GD.xsprite(x, y, -16, 0, 32, 5, rot, jk);
-GD.xsprite(x, y, 0, 0, 32, 7, rot, jk);
-break;
-case 1:
-GD.xsprite(x, y, -16, -16, 33, 5, rot, jk);
-GD.xsprite(x, y, 0, -16, 33, 7, rot, jk);
-GD.xsprite(x, y, -16, 0, 34, 5, rot, jk);
-GD.xsprite(x, y, 0, 0, 34, 7, rot, jk);
-break;
-case 2:
-GD.xsprite(x, y, -16, -16, 35, 5, rot, jk);
-GD.xsprite(x, y, 0, -16, 35, 7, rot, jk);
-GD.xsprite(x, y, -16, 0, 36, 5, rot, jk);
-GD.xsprite(x, y, 0, 0, 36, 7, rot, jk);
-break;
-case 3:
-GD.xsprite(x, y, -16, -16, 37, 5, rot, jk);
-GD.xsprite(x, y, 0, -16, 37, 7, rot, jk);
-GD.xsprite(x, y, -16, 0, 38, 5, rot, jk);
-GD.xsprite(x, y, 0, 0, 38, 7, rot, jk);
-break;
-
-    }
-}
+static PROGMEM prog_uchar rock1r_metasprite[] = {
+
+0x04,  0x09,  0x00,  0x1a,  0x00,  0x2b,  0x00,  0x3c,  0x00,  0x04,  0xf0,  0xf0,  0x1f,  0x05,  0x00,  0xf0, 
+0x1f,  0x07,  0xf0,  0x00,  0x20,  0x05,  0x00,  0x00,  0x20,  0x07,  0x04,  0xf0,  0xf0,  0x21,  0x05,  0x00, 
+0xf0,  0x21,  0x07,  0xf0,  0x00,  0x22,  0x05,  0x00,  0x00,  0x22,  0x07,  0x04,  0xf0,  0xf0,  0x23,  0x05, 
+0x00,  0xf0,  0x23,  0x07,  0xf0,  0x00,  0x24,  0x05,  0x00,  0x00,  0x24,  0x07,  0x04,  0xf0,  0xf0,  0x25, 
+0x05,  0x00,  0xf0,  0x25,  0x07,  0xf0,  0x00,  0x26,  0x05,  0x00,  0x00,  0x26,  0x07, 
+};
 
 static PROGMEM prog_uchar palette4a[] = {
 
 0x1c,  0x03,  0x7f,  0x01,  0x10,  0x00,  0x00,  0x80, 
 };
 #define SPARKR_FRAMES 4
-static void draw_sparkr(int x, int y, byte anim, byte rot, byte jk = 0)
-{
-  switch (anim) {
-    
-case 0:
-GD.xsprite(x, y, -8, -8, 39, 8, rot, jk);
-break;
-case 1:
-GD.xsprite(x, y, -8, -8, 39, 10, rot, jk);
-break;
-case 2:
-GD.xsprite(x, y, -8, -8, 39, 12, rot, jk);
-break;
-case 3:
-GD.xsprite(x, y, -8, -8, 39, 14, rot, jk);
-break;
-
-    }
-}
+static PROGMEM prog_uchar sparkr_metasprite[] = {
+
+0x04,  0x09,  0x00,  0x0e,  0x00,  0x13,  0x00,  0x18,  0x00,  0x01,  0xf8,  0xf8,  0x27,  0x08,  0x01,  0xf8, 
+0xf8,  0x27,  0x0a,  0x01,  0xf8,  0xf8,  0x27,  0x0c,  0x01,  0xf8,  0xf8,  0x27,  0x0e, 
+};
 
 static PROGMEM prog_uchar palette256a[] = {
 
@@ -763,37 +622,14 @@ static PROGMEM prog_uchar palette256a[] = {
 0x29,  0x25,  0xf0,  0x18,  0xc5,  0x18,  0xa0,  0x20,  0x50,  0x04,  0x45,  0x04,  0x63,  0x0c,  0x00,  0x80, 
 };
 #define PLAYER_FRAMES 4
-static void draw_player(int x, int y, byte anim, byte rot, byte jk = 0)
-{
-  switch (anim) {
-    
-case 0:
-GD.xsprite(x, y, -16, -16, 40, 0, rot, jk);
-GD.xsprite(x, y, 0, -16, 40, 1, rot, jk);
-GD.xsprite(x, y, -16, 0, 41, 0, rot, jk);
-GD.xsprite(x, y, 0, 0, 41, 1, rot, jk);
-break;
-case 1:
-GD.xsprite(x, y, -16, -16, 42, 0, rot, jk);
-GD.xsprite(x, y, 0, -16, 42, 1, rot, jk);
-GD.xsprite(x, y, -16, 0, 43, 0, rot, jk);
-GD.xsprite(x, y, 0, 0, 43, 1, rot, jk);
-break;
-case 2:
-GD.xsprite(x, y, -16, -16, 44, 0, rot, jk);
-GD.xsprite(x, y, 0, -16, 44, 1, rot, jk);
-GD.xsprite(x, y, -16, 0, 45, 0, rot, jk);
-GD.xsprite(x, y, 0, 0, 45, 1, rot, jk);
-break;
-case 3:
-GD.xsprite(x, y, -16, -16, 46, 0, rot, jk);
-GD.xsprite(x, y, 0, -16, 46, 1, rot, jk);
-GD.xsprite(x, y, -16, 0, 47, 0, rot, jk);
-GD.xsprite(x, y, 0, 0, 47, 1, rot, jk);
-break;
-
-    }
-}
+static PROGMEM prog_uchar player_metasprite[] = {
+
+0x04,  0x09,  0x00,  0x1a,  0x00,  0x2b,  0x00,  0x3c,  0x00,  0x04,  0xf0,  0xf0,  0x28,  0x00,  0x00,  0xf0, 
+0x28,  0x01,  0xf0,  0x00,  0x29,  0x00,  0x00,  0x00,  0x29,  0x01,  0x04,  0xf0,  0xf0,  0x2a,  0x00,  0x00, 
+0xf0,  0x2a,  0x01,  0xf0,  0x00,  0x2b,  0x00,  0x00,  0x00,  0x2b,  0x01,  0x04,  0xf0,  0xf0,  0x2c,  0x00, 
+0x00,  0xf0,  0x2c,  0x01,  0xf0,  0x00,  0x2d,  0x00,  0x00,  0x00,  0x2d,  0x01,  0x04,  0xf0,  0xf0,  0x2e, 
+0x00,  0x00,  0xf0,  0x2e,  0x01,  0xf0,  0x00,  0x2f,  0x00,  0x00,  0x00,  0x2f,  0x01, 
+};
 
 static PROGMEM prog_uchar asteroid_images_compressed[] = {
 